@@ -0,0 +1,417 @@
+/*
+  ==============================================================================
+
+    AnalysisScheduler.h
+    Process-wide worker pool that runs the analyzer work of every open editor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SpectrumAnalyzer.h"
+#include "SpectrumTraces.h"
+#include "MatchEQ.h"
+#include "ResonanceDetector.h"
+
+//==============================================================================
+// One scheduler is shared by every plugin instance in the process (held through
+// juce::SharedResourcePointer). A couple of worker threads run the registered
+// jobs instead of each editor doing its FFTs on the message thread:
+//
+//   focused    - editor window focused or under the mouse: every frame interval
+//   background - visible but not focused: at most backgroundIntervalMs
+//   hidden     - not analysed at all
+//
+// Due jobs are served highest priority first, then most overdue first. After
+// each job a worker rests in proportion to the time it took, so the pool never
+// uses more than numWorkers * maxWorkerLoad of a core, however many instances
+// are open. Under overload the background editors slow down first.
+//==============================================================================
+class AnalysisScheduler
+{
+public:
+    enum class Priority { hidden, background, focused };
+
+    static constexpr double backgroundIntervalMs = 1000.0 / 15.0;
+    static constexpr double maxWorkerLoad = 0.5;   // busy fraction per worker
+    static constexpr int idleWaitMs = 10;          // poll period with nothing due
+
+    class Job
+    {
+    public:
+        virtual ~Job() = default;
+
+        // Worker thread; never runs concurrently with itself
+        virtual void runAnalysis() = 0;
+
+        // Any thread. intervalMs is the rate wanted while focused.
+        void setPriority (Priority p, double intervalMs) noexcept
+        {
+            priority.store (static_cast<int> (p));
+            focusedIntervalMs.store (intervalMs);
+        }
+
+        Priority getPriority() const noexcept { return static_cast<Priority> (priority.load()); }
+
+    private:
+        friend class AnalysisScheduler;
+
+        std::atomic<int> priority { static_cast<int> (Priority::background) };
+        std::atomic<double> focusedIntervalMs { 1000.0 / 60.0 };
+
+        // Guarded by the scheduler lock
+        double lastRunMs = 0.0;
+        bool running = false;
+
+        // Signalled by endJob, for removeJob to wait on
+        juce::WaitableEvent finished;
+    };
+
+    // Cumulative since the scheduler started, so every caller can take its own deltas
+    // (the scheduler is shared by all editors). A default Stats is the start itself.
+    struct Stats
+    {
+        int numJobs = 0;
+        int numWorkers = 0;
+        double elapsedMs = 0.0;         // since the scheduler started
+        double busyMs = 0.0;            // summed over all workers
+        juce::int64 numRuns = 0;
+
+        // Busy fraction of the whole pool between an earlier snapshot and this one
+        double getLoadSince (const Stats& earlier) const noexcept
+        {
+            return (busyMs - earlier.busyMs) / (getMsSince (earlier) * juce::jmax (1, numWorkers));
+        }
+
+        double getJobsPerSecondSince (const Stats& earlier) const noexcept
+        {
+            return 1000.0 * static_cast<double> (numRuns - earlier.numRuns) / getMsSince (earlier);
+        }
+
+        double getMsSince (const Stats& earlier) const noexcept
+        {
+            return juce::jmax (1.0, elapsedMs - earlier.elapsedMs);
+        }
+    };
+
+    //==============================================================================
+    AnalysisScheduler()
+    {
+        const int numWorkers = juce::jlimit (1, 2, juce::SystemStats::getNumPhysicalCpus() / 4);
+        for (int i = 0; i < numWorkers; ++i)
+            workers.add (new Worker (*this, i));
+
+        startMs = juce::Time::getMillisecondCounterHiRes();
+
+        for (auto* w : workers)
+            w->startThread (juce::Thread::Priority::low);
+    }
+
+    ~AnalysisScheduler()
+    {
+        for (auto* w : workers)
+            w->signalThreadShouldExit();
+        for (auto* w : workers)
+            w->stopThread (2000);
+    }
+
+    void addJob (Job& job)
+    {
+        {
+            const juce::ScopedLock sl (lock);
+            job.lastRunMs = 0.0;
+            job.running = false;
+            jobs.addIfNotAlreadyThere (&job);
+        }
+
+        for (auto* w : workers)
+            w->notify();
+    }
+
+    // Blocks until the job is not running, so it can be destroyed straight after.
+    // Once removed no worker can claim it again, so at most the current run is waited for.
+    void removeJob (Job& job)
+    {
+        {
+            const juce::ScopedLock sl (lock);
+            jobs.removeFirstMatchingValue (&job);
+
+            if (! job.running)
+                return;
+
+            job.finished.reset();   // drop signals of earlier runs
+        }
+
+        job.finished.wait();
+    }
+
+    // Snapshot; reading it changes nothing
+    Stats getStats() const
+    {
+        const juce::ScopedLock sl (lock);
+
+        Stats s;
+        s.numJobs = jobs.size();
+        s.numWorkers = workers.size();
+        s.elapsedMs = juce::Time::getMillisecondCounterHiRes() - startMs;
+        s.busyMs = busyMs;
+        s.numRuns = numRuns;
+        return s;
+    }
+
+private:
+    //==============================================================================
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker (AnalysisScheduler& s, int index)
+            : juce::Thread ("Analysis worker " + juce::String (index + 1)), owner (s) {}
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                double waitMs = idleWaitMs;
+
+                if (auto* job = owner.beginNextJob (waitMs))
+                {
+                    const double start = juce::Time::getMillisecondCounterHiRes();
+                    job->runAnalysis();
+                    const double elapsed = juce::Time::getMillisecondCounterHiRes() - start;
+
+                    owner.endJob (*job, elapsed);
+                    waitMs = elapsed * (1.0 - maxWorkerLoad) / maxWorkerLoad;
+                }
+
+                if (waitMs >= 0.5)
+                    wait (juce::jmax (1, juce::roundToInt (waitMs)));
+            }
+        }
+
+    private:
+        AnalysisScheduler& owner;
+    };
+
+    // Picks and claims the most urgent due job; otherwise sets waitMs to the time
+    // until the next one is due
+    Job* beginNextJob (double& waitMs)
+    {
+        const juce::ScopedLock sl (lock);
+        const double now = juce::Time::getMillisecondCounterHiRes();
+
+        Job* best = nullptr;
+        int bestPriority = -1;
+        double bestLateness = 0.0;
+
+        for (auto* job : jobs)
+        {
+            const auto priority = job->getPriority();
+            if (job->running || priority == Priority::hidden)
+                continue;
+
+            double interval = job->focusedIntervalMs.load();
+            if (priority == Priority::background)
+                interval = juce::jmax (interval, backgroundIntervalMs);
+
+            const double lateness = now - (job->lastRunMs + interval);
+            if (lateness < 0.0)
+            {
+                waitMs = juce::jmin (waitMs, -lateness);
+                continue;
+            }
+
+            const int p = static_cast<int> (priority);
+            if (p > bestPriority || (p == bestPriority && lateness > bestLateness))
+            {
+                best = job;
+                bestPriority = p;
+                bestLateness = lateness;
+            }
+        }
+
+        if (best != nullptr)
+        {
+            // Cadence restarts from now, so a starved job does not burst to catch up
+            best->running = true;
+            best->lastRunMs = now;
+        }
+
+        return best;
+    }
+
+    void endJob (Job& job, double elapsedMs)
+    {
+        const juce::ScopedLock sl (lock);
+        job.running = false;
+        job.finished.signal();
+        busyMs += elapsedMs;
+        ++numRuns;
+    }
+
+    juce::CriticalSection lock;
+    juce::Array<Job*> jobs;
+    juce::OwnedArray<Worker> workers;
+
+    double startMs = 0.0;
+
+    // Guarded by lock, never reset
+    double busyMs = 0.0;
+    juce::int64 numRuns = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (AnalysisScheduler)
+};
+
+//==============================================================================
+// Pre- and post-EQ analysis of one processor as a scheduler job. The worker
+// publishes each frame by copy; the GUI swaps the newest one out. The post-EQ
+// peak-hold / average / max-hold traces and the resonance detector run here
+// too. Frames are only analysed at the job's scheduled rate (and not while
+// hidden), so each one is folded in with the audio time since the previous one,
+// which keeps hold, fall and averaging times in real seconds at any rate.
+//==============================================================================
+class SpectrumAnalysisJob : public AnalysisScheduler::Job
+{
+public:
+    SpectrumAnalysisJob (SpectrumAnalyzer& preAnalyzer, SpectrumAnalyzer& postAnalyzer)
+        : pre (preAnalyzer), post (postAnalyzer)
+    {
+        scheduler->addJob (*this);
+    }
+
+    ~SpectrumAnalysisJob() override
+    {
+        scheduler->removeJob (*this);
+    }
+
+    void runAnalysis() override
+    {
+        if (! SpectrumAnalyzer::processFFTPair (pre, post, workPre, workPost))
+            return;
+
+        // Fold each post-EQ frame in once, even when only the pre-EQ frame was new
+        const bool newPost = post.getLastFrameEnd() != lastPostFrame;
+        lastPostFrame = post.getLastFrameEnd();
+        const auto postSeconds = static_cast<float> (post.getLastFrameSeconds());
+
+        const bool tracesEnabled = newPost && postTraces.isAnyEnabled();
+        if (tracesEnabled)
+            postTraces.process (workPost, postSeconds);
+
+        const bool resonancesFound = newPost && resonanceDetection.load()
+                                  && resonances.process (workPost, post.getSampleRate(), postSeconds);
+
+        // Long-term capture of the plugin input for match EQ
+        if (auto* capture = inputCapture.load(); capture != nullptr && pre.getLastFrameEnd() != lastCapturedFrame)
+        {
+            capture->add (workPre, pre.getSampleRate());
+            lastCapturedFrame = pre.getLastFrameEnd();
+        }
+
+        const juce::SpinLock::ScopedLockType sl (frameLock);
+        sharedPre = workPre;     // same size except after a resolution change, so no allocation
+        sharedPost = workPost;
+        hasNewFrame = true;
+
+        if (tracesEnabled)
+        {
+            sharedPeakHold = postTraces.getPeakHold();
+            sharedAverage = postTraces.getAverage();
+            sharedMaxHold = postTraces.getMaxHold();
+            hasNewTraces = true;
+        }
+
+        if (resonancesFound)
+        {
+            sharedSuggestions = resonances.getSuggestions();   // reuses capacity after the first copy
+            hasNewSuggestions = true;
+        }
+    }
+
+    // GUI thread: swaps in the newest frame, if one arrived since the last call
+    bool pullFrame (std::vector<float>& preDB, std::vector<float>& postDB)
+    {
+        const juce::SpinLock::ScopedLockType sl (frameLock);
+        if (! hasNewFrame)
+            return false;
+
+        std::swap (preDB, sharedPre);
+        std::swap (postDB, sharedPost);
+        hasNewFrame = false;
+        return true;
+    }
+
+    // GUI thread: swaps in the newest traces, if they changed since the last call.
+    // Traces that are switched off come back as copies of the live frame.
+    bool pullTraces (std::vector<float>& peakHold, std::vector<float>& average, std::vector<float>& maxHold)
+    {
+        const juce::SpinLock::ScopedLockType sl (frameLock);
+        if (! hasNewTraces)
+            return false;
+
+        std::swap (peakHold, sharedPeakHold);
+        std::swap (average, sharedAverage);
+        std::swap (maxHold, sharedMaxHold);
+        hasNewTraces = false;
+        return true;
+    }
+
+    // Trace settings; any thread
+    SpectrumTraces& getPostTraces() noexcept { return postTraces; }
+
+    // Any thread: switches the post-EQ resonance search; switching it on starts afresh
+    void setResonanceDetection (bool enabled)
+    {
+        if (enabled && ! resonanceDetection.load())
+            resonances.reset();
+        resonanceDetection.store (enabled);
+    }
+
+    bool isResonanceDetectionEnabled() const noexcept { return resonanceDetection.load(); }
+
+    // GUI thread: copies the newest resonance suggestions, if they changed since the last call
+    bool pullResonances (std::vector<ResonanceDetector::Suggestion>& dest)
+    {
+        const juce::SpinLock::ScopedLockType sl (frameLock);
+        if (! hasNewSuggestions)
+            return false;
+
+        dest = sharedSuggestions;
+        hasNewSuggestions = false;
+        return true;
+    }
+
+    // Any thread: adds every pre-EQ frame to capture until set back to nullptr.
+    // The capture must outlive the job.
+    void setInputCapture (SpectrumCapture* capture) noexcept { inputCapture.store (capture); }
+    SpectrumCapture* getInputCapture() const noexcept       { return inputCapture.load(); }
+
+    AnalysisScheduler::Stats getSchedulerStats() const { return scheduler->getStats(); }
+
+private:
+    SpectrumAnalyzer& pre;
+    SpectrumAnalyzer& post;
+
+    std::vector<float> workPre, workPost;       // worker only
+    std::vector<float> sharedPre, sharedPost;   // guarded by frameLock
+    bool hasNewFrame = false;
+
+    SpectrumTraces postTraces;
+    juce::int64 lastPostFrame = 0;                                     // worker only
+
+    ResonanceDetector resonances;                                      // worker only
+    std::atomic<bool> resonanceDetection { false };
+    std::vector<ResonanceDetector::Suggestion> sharedSuggestions;      // guarded by frameLock
+    bool hasNewSuggestions = false;
+
+    std::atomic<SpectrumCapture*> inputCapture { nullptr };
+    juce::int64 lastCapturedFrame = 0;                                 // worker only
+    std::vector<float> sharedPeakHold, sharedAverage, sharedMaxHold;   // guarded by frameLock
+    bool hasNewTraces = false;
+    juce::SpinLock frameLock;
+
+    juce::SharedResourcePointer<AnalysisScheduler> scheduler;
+
+    JUCE_DECLARE_NON_COPYABLE (SpectrumAnalysisJob)
+};
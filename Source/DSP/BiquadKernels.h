@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+    BiquadKernels.h
+    Second-order section kernels specialised on each filter type's coefficient
+    structure
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Transposed direct form II, as juce::dsp::IIR::Filter, with one kernel per
+// coefficient structure. The designs the bands use (DynamicEQBand::designCoefficients,
+// normalised, a0 = 1, computed in place without allocating) have fixed relations
+// between their coefficients, so some products are shared or drop out:
+//
+//   structure   relation                   multiplies / sample
+//   general     none (shelves)             5
+//   peak        b1 = a1                    4
+//   notch       b0 = b2, b1 = a1           3
+//   lowPass     b1 = 2 b0, b2 = b0         3
+//   highPass    b1 = -2 b0, b2 = b0        3
+//   bandPass    b1 = 0, b2 = -b0           3
+//
+// get() returns a plain function pointer, so the type is resolved once when
+// the coefficients of a new type are loaded and the sample loop itself has no
+// branches on it. Each kernel processes one channel.
+//==============================================================================
+namespace BiquadKernels
+{
+    enum class Structure { general, peak, notch, lowPass, highPass, bandPass };
+
+    struct Coefficients
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    };
+
+    struct State
+    {
+        float s1 = 0.0f, s2 = 0.0f;
+    };
+
+    using Kernel = void (*) (const Coefficients&, State&, float*, int) noexcept;
+
+    template <Structure S>
+    void process (const Coefficients& c, State& state, float* data, int numSamples) noexcept
+    {
+        const float b0 = c.b0, b1 = c.b1, b2 = c.b2, a1 = c.a1, a2 = c.a2;
+        float s1 = state.s1, s2 = state.s2;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = data[i];
+            float y;
+
+            if constexpr (S == Structure::general)
+            {
+                y  = b0 * x + s1;
+                s1 = b1 * x - a1 * y + s2;
+                s2 = b2 * x - a2 * y;
+            }
+            else if constexpr (S == Structure::peak)
+            {
+                y  = b0 * x + s1;
+                s1 = a1 * (x - y) + s2;
+                s2 = b2 * x - a2 * y;
+            }
+            else if constexpr (S == Structure::notch)
+            {
+                const float bx = b0 * x;
+                y  = bx + s1;
+                s1 = a1 * (x - y) + s2;
+                s2 = bx - a2 * y;
+            }
+            else if constexpr (S == Structure::lowPass)
+            {
+                const float bx = b0 * x;
+                y  = bx + s1;
+                s1 = (bx + bx) - a1 * y + s2;
+                s2 = bx - a2 * y;
+            }
+            else if constexpr (S == Structure::highPass)
+            {
+                const float bx = b0 * x;
+                y  = bx + s1;
+                s1 = s2 - (bx + bx) - a1 * y;
+                s2 = bx - a2 * y;
+            }
+            else
+            {
+                const float bx = b0 * x;
+                y  = bx + s1;
+                s1 = s2 - a1 * y;
+                s2 = -bx - a2 * y;
+            }
+
+            data[i] = y;
+        }
+
+        juce::ignoreUnused (b1, b2);
+        state.s1 = juce::dsp::util::snapToZero (s1);
+        state.s2 = juce::dsp::util::snapToZero (s2);
+    }
+
+    // True if c has the relations the structure's kernel relies on (exactly: the
+    // kernels drop the coefficients they imply)
+    inline bool hasStructure (const Coefficients& c, Structure structure) noexcept
+    {
+        switch (structure)
+        {
+            case Structure::peak:     return c.b1 == c.a1;
+            case Structure::notch:    return c.b0 == c.b2 && c.b1 == c.a1;
+            case Structure::lowPass:  return c.b1 == 2.0f * c.b0 && c.b2 == c.b0;
+            case Structure::highPass: return c.b1 == -2.0f * c.b0 && c.b2 == c.b0;
+            case Structure::bandPass: return c.b1 == 0.0f && c.b2 == -c.b0;
+            case Structure::general:  break;
+        }
+
+        return true;
+    }
+
+    inline Kernel get (Structure structure) noexcept
+    {
+        switch (structure)
+        {
+            case Structure::peak:     return process<Structure::peak>;
+            case Structure::notch:    return process<Structure::notch>;
+            case Structure::lowPass:  return process<Structure::lowPass>;
+            case Structure::highPass: return process<Structure::highPass>;
+            case Structure::bandPass: return process<Structure::bandPass>;
+            case Structure::general:  break;
+        }
+
+        return process<Structure::general>;
+    }
+}
@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    BiquadResponse.h
+    Closed-form biquad magnitude response over a fixed frequency grid
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FastMath.h"
+
+//==============================================================================
+// Evaluates |H(e^jw)| in dB for many filters on the same frequency grid.
+//
+// The only frequency-dependent term is phi = sin^2(w / 2), computed once per
+// grid. With it the squared magnitude of each biquad is a ratio of two
+// quadratics in phi (the cancellation-free form of the cos(w) / cos(2w)
+// expansion, so low frequencies stay accurate in float):
+//
+//   |B|^2 = (b0 + b1 + b2)^2 - 4 phi (b0 b1 + b1 b2 + 4 b0 b2) + 16 b0 b2 phi^2
+//
+// and likewise for the denominator with b -> (1, a1, a2). The per-point loop
+// has no branches or complex arithmetic and vectorises; dB conversion uses
+// FastMath. Used by the display curve and the offline tools.
+//==============================================================================
+class BiquadResponse
+{
+public:
+    BiquadResponse() = default;
+
+    // Precompute the grid terms; call when the grid or sample rate changes
+    void prepare (const double* frequencies, int numPoints, double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        phi.resize (static_cast<size_t> (juce::jmax (0, numPoints)));
+
+        for (size_t i = 0; i < phi.size(); ++i)
+        {
+            const double s = std::sin (juce::MathConstants<double>::pi * frequencies[i] / sampleRate);
+            phi[i] = static_cast<float> (s * s);
+        }
+    }
+
+    int getNumPoints() const noexcept     { return static_cast<int> (phi.size()); }
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    // Magnitude in dB of a first- or second-order filter at every grid point
+    void getMagnitudeDB (const juce::dsp::IIR::Coefficients<float>& c, float* destDB) const noexcept
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        const auto* raw = c.coefficients.getRawDataPointer();
+
+        if (c.coefficients.size() >= 5)
+        {
+            b0 = raw[0]; b1 = raw[1]; b2 = raw[2]; a1 = raw[3]; a2 = raw[4];
+        }
+        else if (c.coefficients.size() >= 3)
+        {
+            b0 = raw[0]; b1 = raw[1]; a1 = raw[2];
+        }
+
+        const auto num = Quadratic::fromCoefficients (b0, b1, b2);
+        const auto den = Quadratic::fromCoefficients (1.0, a1, a2);
+        const int n = getNumPoints();
+        const float* p = phi.data();
+
+        for (int i = 0; i < n; ++i)
+        {
+            const float x  = p[i];
+            const float nn = juce::jmax (powerFloor, num.c0 + x * (num.c1 + x * num.c2));
+            const float dd = juce::jmax (powerFloor, den.c0 + x * (den.c1 + x * den.c2));
+            destDB[i] = FastMath::powerToDecibels (nn / dd);
+        }
+    }
+
+private:
+    // |b0 + b1 z^-1 + b2 z^-2|^2 as c0 + c1 phi + c2 phi^2
+    struct Quadratic
+    {
+        float c0, c1, c2;
+
+        static Quadratic fromCoefficients (double b0, double b1, double b2) noexcept
+        {
+            const double sum = b0 + b1 + b2;
+            return { static_cast<float> (sum * sum),
+                     static_cast<float> (-4.0 * (b0 * b1 + b1 * b2 + 4.0 * b0 * b2)),
+                     static_cast<float> (16.0 * b0 * b2) };
+        }
+    };
+
+    static constexpr float powerFloor = 1.0e-30f;   // -300 dB; keeps the log argument normal
+
+    std::vector<float> phi;
+    double sampleRate = 44100.0;
+
+    JUCE_DECLARE_NON_COPYABLE (BiquadResponse)
+};
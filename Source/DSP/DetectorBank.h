@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+    DetectorBank.h
+    Envelope detectors and gain computers of all bands, updated in one pass
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FastMath.h"
+
+//==============================================================================
+// Struct-of-arrays state for every band's dynamics: one array per field, so each
+// step of an update is a plain loop across bands with selects instead of branches
+// and FastMath instead of libm, which the compiler vectorises (4-8 bands per
+// instruction). An update is one level in, one reduction per band out:
+//
+//   coeff     = 2^(n * rate)                 rate = -log2(e) / (sr * ms / 1000)
+//   envelope  = coeff * envelope + (1 - coeff) * level
+//   envDB     = 20 log10 (max (envelope, 1e-5))                      -100 dB floor
+//   reduction = max (0, envDB - threshold) * (1 - 1 / ratio)
+//
+// rate is the attack or the release rate depending on whether the level is above
+// the envelope, so coeff is the per-sample coefficient raised to the update length
+// n. Times stay in milliseconds at any update rate, from per-sample to per-block.
+// Per-sample updates (n = 1) use the per-sample coefficients directly: near 1 the
+// relative error of exp2 would be magnified in (1 - coeff).
+//
+// Error bounds:
+//   - coeff (n > 1): FastMath::exp2 relative error 1.8e-7
+//   - envDB: FastMath::log2 absolute error 2e-5, i.e. 1.2e-4 dB
+//   - reduction: the envDB error times the slope, plus float rounding. Measured
+//     against a double-precision reference: < 1e-4 dB per block, < 3e-3 dB per
+//     sample, where float envelopes with coefficients near 1 dominate, as in the
+//     scalar std::exp / Decibels formulation (the two differ by < 2e-4 dB)
+// All far below the 0.01 dB resolution of the gain that the filters receive.
+//
+// Bands without dynamics (or disabled) have a zero slope: their envelope keeps
+// tracking, but their reduction is always 0.
+//
+// The bank also keeps a long-term average of the input level in dB (time constant
+// longTermSeconds), the "usual" level in the detectors' own domain, from which
+// thresholds that should only catch rises above it are derived.
+//==============================================================================
+template <int MaxBands>
+class DetectorBank
+{
+public:
+    static constexpr float floorGain = 1.0e-5f;    // -100 dB, the detectors' level floor
+    static constexpr double longTermSeconds = 3.0;
+
+    void prepare (double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        for (int i = 0; i < MaxBands; ++i)
+            updateRates (i);
+        longTermRate = rateFor (static_cast<float> (longTermSeconds * 1000.0));
+        hasLongTermLevel = false;
+        reset();
+    }
+
+    // Clears the envelopes; the long-term level is kept, so it still holds the usual
+    // level when processing resumes after silence
+    void reset()
+    {
+        envelope.fill (0.0f);
+    }
+
+    // Cheap when nothing changed: the rates are only recomputed when a time moved
+    void setBand (int index, float attackMs, float releaseMs, float thresholdDB, float ratio, bool dynamicOn)
+    {
+        jassert (juce::isPositiveAndBelow (index, MaxBands));
+        const auto i = static_cast<size_t> (index);
+
+        threshold[i] = thresholdDB;
+        slope[i] = (dynamicOn && ratio > 0.0f) ? 1.0f - 1.0f / ratio : 0.0f;
+
+        if (attackMs != attackTimes[i] || releaseMs != releaseTimes[i])
+        {
+            attackTimes[i]  = attackMs;
+            releaseTimes[i] = releaseMs;
+            updateRates (index);
+        }
+    }
+
+    // Advances bands 0..numBands - 1 by numSamples with the same input level (linear peak)
+    // and writes their gain reductions in dB (>= 0)
+    void process (float level, int numSamples, int numBands, float* reductionDB) noexcept
+    {
+        level = level > floorGain ? level : 0.0f;
+        updateLongTermLevel (level, numSamples);
+
+        if (numSamples == 1)
+        {
+            for (int i = 0; i < numBands; ++i)
+            {
+                const auto k = static_cast<size_t> (i);
+                const float env = envelope[k];
+                const float coeff = level > env ? attackCoeff[k] : releaseCoeff[k];
+                envelope[k] = level + coeff * (env - level);
+            }
+        }
+        else
+        {
+            const auto n = static_cast<float> (numSamples);
+            for (int i = 0; i < numBands; ++i)
+            {
+                const auto k = static_cast<size_t> (i);
+                const float env = envelope[k];
+                const float coeff = FastMath::exp2 (n * (level > env ? attackRate[k] : releaseRate[k]));
+                envelope[k] = level + coeff * (env - level);
+            }
+        }
+
+        for (int i = 0; i < numBands; ++i)
+        {
+            const auto k = static_cast<size_t> (i);
+            const float envDB = toDecibels (envelope[k]);
+            reductionDB[i] = juce::jmax (0.0f, envDB - threshold[k]) * slope[k];
+        }
+    }
+
+    float getEnvelope (int index) const noexcept { return envelope[static_cast<size_t> (index)]; }
+
+    // Long-term average input level in dB (-100 before the first level above the floor)
+    float getLongTermLevelDB() const noexcept { return longTermLevelDB; }
+
+private:
+    static float toDecibels (float gain) noexcept
+    {
+        return 6.0205999133f * FastMath::log2 (juce::jmax (gain, floorGain));
+    }
+
+    // Starts at the first level above the floor instead of ramping up from -100 dB
+    void updateLongTermLevel (float level, int numSamples) noexcept
+    {
+        if (level <= 0.0f)
+            return;
+
+        const float levelDB = toDecibels (level);
+        const float coeff = hasLongTermLevel ? FastMath::exp2 (static_cast<float> (numSamples) * longTermRate) : 0.0f;
+        longTermLevelDB = levelDB + coeff * (longTermLevelDB - levelDB);
+        hasLongTermLevel = true;
+    }
+
+    void updateRates (int index)
+    {
+        const auto i = static_cast<size_t> (index);
+        attackRate[i]   = rateFor (attackTimes[i]);
+        releaseRate[i]  = rateFor (releaseTimes[i]);
+        attackCoeff[i]  = static_cast<float> (std::exp2 (static_cast<double> (attackRate[i])));
+        releaseCoeff[i] = static_cast<float> (std::exp2 (static_cast<double> (releaseRate[i])));
+    }
+
+    // log2 of the per-sample coefficient exp (-1 / (sr * ms / 1000)); a zero time jumps
+    float rateFor (float ms) const noexcept
+    {
+        const double samples = sampleRate * ms * 0.001;
+        return samples > 0.0 ? static_cast<float> (-1.4426950409 / samples) : -1000.0f;
+    }
+
+    double sampleRate = 44100.0;
+    float longTermRate = 0.0f;
+    float longTermLevelDB = -100.0f;
+    bool hasLongTermLevel = false;
+
+    alignas (16) std::array<float, MaxBands> envelope {};
+    alignas (16) std::array<float, MaxBands> attackRate {}, releaseRate {};     // log2 of the per-sample coefficients
+    alignas (16) std::array<float, MaxBands> attackCoeff {}, releaseCoeff {};
+    alignas (16) std::array<float, MaxBands> threshold {}, slope {};
+    std::array<float, MaxBands> attackTimes {}, releaseTimes {};
+};
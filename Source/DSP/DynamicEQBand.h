@@ -10,6 +10,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BiquadKernels.h"
 
 //==============================================================================
 // Parameters for a single Dynamic EQ band
@@ -32,77 +33,100 @@ struct BandParams
 };
 
 //==============================================================================
-// Envelope follower for dynamic gain reduction
-//==============================================================================
-class EnvelopeFollower
-{
-public:
-    void prepare (double newSampleRate)
-    {
-        sampleRate = newSampleRate;
-        envelope = 0.0f;
-    }
-
-    void setAttackRelease (float attackMs, float releaseMs)
-    {
-        if (sampleRate <= 0.0)
-            return;
-        attackCoeff  = std::exp (-1.0f / (static_cast<float> (sampleRate) * attackMs * 0.001f));
-        releaseCoeff = std::exp (-1.0f / (static_cast<float> (sampleRate) * releaseMs * 0.001f));
-    }
-
-    float process (float inputLevel)
-    {
-        float coeff = (inputLevel > envelope) ? attackCoeff : releaseCoeff;
-        envelope = coeff * envelope + (1.0f - coeff) * inputLevel;
-        return envelope;
-    }
-
-    float getEnvelope() const { return envelope; }
-
-private:
-    double sampleRate = 44100.0;
-    float attackCoeff  = 0.0f;
-    float releaseCoeff = 0.0f;
-    float envelope     = 0.0f;
-};
-
-//==============================================================================
-// A single Dynamic EQ band processing unit
+// A single Dynamic EQ band processing unit. Its detector and gain computer live in
+// the processor's DetectorBank, which updates all bands at once; process() gets
+// the resulting reduction.
 //==============================================================================
 class DynamicEQBand
 {
 public:
     static constexpr int maxOrder = 2; // second-order IIR
 
+    // Decay floor used for tail / idle detection (-120 dB)
+    static constexpr float silenceFloor = 1.0e-6f;
+
+    // Parameter smoothing: ramp length, and how often coefficients follow the ramp
+    static constexpr double smoothingSeconds = 0.05;
+    static constexpr int    controlInterval  = 32;   // samples per coefficient update while ramping
+
     void prepare (const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = spec.sampleRate;
-        envelopeFollower.prepare (sampleRate);
 
-        for (auto& f : filters)
-        {
-            f.reset();
-            f.prepare (spec);
-        }
+        filterStates.assign (spec.numChannels, {});
 
-        // Sidechain bandpass filter for envelope detection
-        sidechainFilter.reset();
-        sidechainFilter.prepare (spec);
+        // Dry copy for the crossfade when the band leaves the cascade
+        dryBuffer.setSize (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+        elided = false;
+
+        // Frequency and Q ramp in the log domain, gain linearly in dB
+        smoothedFreq.reset (sampleRate, smoothingSeconds);
+        smoothedQ.reset    (sampleRate, smoothingSeconds);
+        smoothedGain.reset (sampleRate, smoothingSeconds);
+        smoothedFreq.setCurrentAndTargetValue (params.frequency);
+        smoothedQ.setCurrentAndTargetValue    (params.q);
+        smoothedGain.setCurrentAndTargetValue (params.gain);
+        appliedCoeffs = {};
+
+        // Everything derived from the sample rate (tail lengths) is rebuilt
+        // by the next updateParams, even when the parameters themselves did not change
+        paramsInitialised = false;
 
         gainReductionDB.store (0.0f);
     }
 
+    // Clear filter state (used when the processor goes idle on silence)
+    void reset()
+    {
+        std::fill (filterStates.begin(), filterStates.end(), BiquadKernels::State {});
+        elided = false;
+        gainReductionDB.store (0.0f);
+    }
+
+    // Peak/Shelf at ~0 dB is an identity: the filter is skipped instead of run
+    static constexpr float identityGainDB = 0.01f;
+
+    // Cheap when nothing changed: only differing fields do any work. Frequency, gain and Q
+    // changes start a ramp; type / enable changes jump because the filter shape changes anyway.
+    // Audio thread: allocates nothing.
     void updateParams (const BandParams& p)
     {
+        const bool first         = ! paramsInitialised;
+        const bool shapeJump     = first || p.type != params.type || p.enabled != params.enabled;
+        const bool shapeChanged  = shapeJump || p.frequency != params.frequency
+                                             || p.q != params.q || p.gain != params.gain
+                                             || p.dynamicOn != params.dynamicOn;
+        const bool timingChanged = first || p.attackMs != params.attackMs || p.releaseMs != params.releaseMs;
+
         params = p;
-        envelopeFollower.setAttackRelease (p.attackMs, p.releaseMs);
-        updateFilterCoefficients (p.gain);
-        updateSidechainFilter();
+        paramsInitialised = true;
+
+        if (shapeJump)
+        {
+            smoothedFreq.setCurrentAndTargetValue (p.frequency);
+            smoothedQ.setCurrentAndTargetValue    (p.q);
+            smoothedGain.setCurrentAndTargetValue (p.gain);
+        }
+        else
+        {
+            smoothedFreq.setTargetValue (p.frequency);
+            smoothedQ.setTargetValue    (p.q);
+            smoothedGain.setTargetValue (p.gain);
+        }
+
+        if (shapeChanged || timingChanged)
+            updateTailLength();
     }
 
-    // Process audio in-place (stereo interleaved via AudioBuffer)
-    void process (juce::AudioBuffer<float>& buffer)
+    // Samples until the filter's ringing has decayed below -120 dB (0 when bypassed)
+    int getFilterTailSamples() const { return filterTailSamples; }
+
+    // Samples until both the filter ringing and the detector envelope are below -120 dB
+    int getIdleTailSamples() const { return idleTailSamples; }
+
+    // Process audio in-place with this block's dynamic gain reduction (dB, >= 0) from the
+    // DetectorBank: the reduction modulates the static gain of the filter
+    void process (juce::AudioBuffer<float>& buffer, float reductionDB)
     {
         if (! params.enabled)
         {
@@ -111,140 +135,300 @@ public:
         }
 
         const int numSamples = buffer.getNumSamples();
-        const int numChannels = buffer.getNumChannels();
+        reductionDB = params.dynamicOn ? reductionDB : 0.0f;
+
+        gainReductionDB.store (reductionDB);
 
-        if (! params.dynamicOn)
+        const bool ramping = smoothedFreq.isSmoothing() || smoothedQ.isSmoothing() || smoothedGain.isSmoothing();
+
+        if (! ramping)
         {
-            // Static EQ - just apply filter
-            auto block = juce::dsp::AudioBlock<float> (buffer);
-            auto context = juce::dsp::ProcessContextReplacing<float> (block);
-            for (auto& f : filters)
-                f.process (context);
-            gainReductionDB.store (0.0f);
+            // Steady parameters: modulate the static gain by the reduction.
+            // Coefficients are only recomputed when the effective gain actually moved.
+            float effectiveGain = params.gain - reductionDB;
+            if (elideIfIdentity (buffer, effectiveGain))
+                return;
+
+            updateFilterCoefficients (params.frequency, params.q, effectiveGain);
+            applyFilters (juce::dsp::AudioBlock<float> (buffer));
             return;
         }
 
-        // Dynamic EQ processing: sample-by-sample gain computation
-        // 1) Detect level using sidechain bandpass
-        // 2) Compute gain reduction
-        // 3) Apply dynamic gain via filter coefficient modulation
-
-        // We'll do a simpler approach: compute per-block gain reduction
-        // and blend the filter gain accordingly
+        // Ramp active: advance the smoothers at control rate and refresh the coefficients
+        // once per controlInterval samples instead of per sample or per block
+        elided = false;
+        juce::dsp::AudioBlock<float> block (buffer);
 
-        // Get sidechain level (mono sum)
-        float peakLevel = 0.0f;
-        for (int ch = 0; ch < numChannels; ++ch)
+        for (int start = 0; start < numSamples; start += controlInterval)
         {
-            const float* data = buffer.getReadPointer (ch);
-            for (int i = 0; i < numSamples; ++i)
-                peakLevel = std::max (peakLevel, std::abs (data[i]));
+            const int len = juce::jmin (controlInterval, numSamples - start);
+            const float freq = smoothedFreq.skip (len);
+            const float q    = smoothedQ.skip (len);
+            const float gain = smoothedGain.skip (len);
+
+            updateFilterCoefficients (freq, q, gain - reductionDB);
+            applyFilters (block.getSubBlock (static_cast<size_t> (start), static_cast<size_t> (len)));
         }
+    }
+
+    // Identity elision can be switched off to compare against the full cascade
+    void setIdentityElisionEnabled (bool shouldElide) { elisionEnabled = shouldElide; }
+    bool isElided() const { return elided; }
 
-        float levelDB = juce::Decibels::gainToDecibels (peakLevel, -100.0f);
-        float envDB = juce::Decibels::gainToDecibels (
-            envelopeFollower.process (juce::Decibels::decibelsToGain (levelDB, -100.0f)),
-            -100.0f);
+    float getGainReductionDB() const { return gainReductionDB.load(); }
+    const BandParams& getParams() const { return params; }
+
+private:
+    bool isGainType() const
+    {
+        return params.type == BandParams::FilterType::LowShelf
+            || params.type == BandParams::FilterType::Peak
+            || params.type == BandParams::FilterType::HighShelf;
+    }
+
+    bool isIdentityGain (float gainDB) const
+    {
+        return isGainType() && std::abs (gainDB) < identityGainDB;
+    }
+
+    void applyFilters (juce::dsp::AudioBlock<float> block)
+    {
+        const auto numChannels = juce::jmin (block.getNumChannels(), filterStates.size());
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            kernel (coefficients, filterStates[ch], block.getChannelPointer (ch), static_cast<int> (block.getNumSamples()));
+    }
 
-        // Compute gain reduction
-        float reductionDB = 0.0f;
-        if (envDB > params.threshold)
+    // Returns true when the band is an identity for this block and the filter was skipped.
+    // On the way out the residual ringing is crossfaded to dry over one block and the state
+    // is cleared - the state an identity biquad settles to - so re-entry is click-free.
+    bool elideIfIdentity (juce::AudioBuffer<float>& buffer, float gainDB)
+    {
+        if (! elisionEnabled || ! isIdentityGain (gainDB))
         {
-            float excess = envDB - params.threshold;
-            reductionDB = excess - excess / params.ratio;
+            elided = false;
+            return false;
         }
 
-        gainReductionDB.store (reductionDB);
+        if (elided)
+            return true;
 
-        // Apply dynamic gain: modulate the static gain by the reduction
-        float dynamicGain = params.gain - reductionDB;
-        updateFilterCoefficients (dynamicGain);
+        const int numSamples = buffer.getNumSamples();
+        const int numChannels = buffer.getNumChannels();
+        if (numSamples > dryBuffer.getNumSamples() || numChannels > dryBuffer.getNumChannels())
+            return false;   // oversized block: keep filtering, retry next block
 
-        auto block = juce::dsp::AudioBlock<float> (buffer);
-        auto context = juce::dsp::ProcessContextReplacing<float> (block);
-        for (auto& f : filters)
-            f.process (context);
-    }
+        for (int ch = 0; ch < numChannels; ++ch)
+            dryBuffer.copyFrom (ch, 0, buffer, ch, 0, numSamples);
 
-    float getGainReductionDB() const { return gainReductionDB.load(); }
-    const BandParams& getParams() const { return params; }
+        updateFilterCoefficients (params.frequency, params.q, gainDB);
+        applyFilters (juce::dsp::AudioBlock<float> (buffer));
 
-private:
-    void updateFilterCoefficients (float gainDB)
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            buffer.applyGainRamp (ch, 0, numSamples, 1.0f, 0.0f);
+            buffer.addFromWithRamp (ch, 0, dryBuffer.getReadPointer (ch), numSamples, 0.0f, 1.0f);
+        }
+
+        std::fill (filterStates.begin(), filterStates.end(), BiquadKernels::State {});
+
+        elided = true;
+        return true;
+    }
+
+    // Skips the coefficient design entirely when the inputs match what is already applied
+    void updateFilterCoefficients (float freq, float q, float gainDB)
     {
         if (sampleRate <= 0.0)
             return;
 
-        juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> coeffs;
+        if (appliedCoeffs.valid && appliedCoeffs.type == params.type && appliedCoeffs.freq == freq
+            && appliedCoeffs.q == q && appliedCoeffs.gainDB == gainDB)
+            return;
+
+        // The kernel only changes with the type: it relies on the structure of that type's design
+        if (! appliedCoeffs.valid || appliedCoeffs.type != params.type)
+            kernel = BiquadKernels::get (getKernelStructure (params.type));
+
+        coefficients = designCoefficients (params.type, sampleRate, freq, q, gainDB);
+        jassert (BiquadKernels::hasStructure (coefficients, getKernelStructure (params.type)));
+        appliedCoeffs = { params.type, freq, q, gainDB, true };
+    }
 
-        switch (params.type)
+public:
+    // Coefficient structure of each type's design in makeCoefficients (see BiquadKernels)
+    static BiquadKernels::Structure getKernelStructure (BandParams::FilterType type) noexcept
+    {
+        switch (type)
         {
+            case BandParams::FilterType::Peak:     return BiquadKernels::Structure::peak;
+            case BandParams::FilterType::Notch:    return BiquadKernels::Structure::notch;
+            case BandParams::FilterType::HighCut:  return BiquadKernels::Structure::lowPass;
+            case BandParams::FilterType::LowCut:   return BiquadKernels::Structure::highPass;
+            case BandParams::FilterType::BandPass: return BiquadKernels::Structure::bandPass;
             case BandParams::FilterType::LowShelf:
-                coeffs.add (juce::dsp::IIR::Coefficients<float>::makeLowShelf (
-                    sampleRate, params.frequency, params.q, juce::Decibels::decibelsToGain (gainDB)));
+            case BandParams::FilterType::HighShelf: break;
+        }
+
+        return BiquadKernels::Structure::general;
+    }
+
+    // Biquad design for one band, normalised (a0 = 1): the RBJ cookbook designs of
+    // juce::dsp::IIR::Coefficients, computed in place. Allocates nothing, so the audio
+    // thread can follow a parameter ramp with it.
+    static BiquadKernels::Coefficients designCoefficients (BandParams::FilterType type, double sr,
+                                                           float freq, float q, float gainDB) noexcept
+    {
+        const double w0    = juce::MathConstants<double>::twoPi * static_cast<double> (freq) / sr;
+        const double cosW0 = std::cos (w0);
+        const double sinW0 = std::sin (w0);
+        const double alpha = sinW0 / (2.0 * static_cast<double> (q));
+        const double A     = std::pow (10.0, static_cast<double> (gainDB) / 40.0);   // sqrt of the linear gain
+
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+
+        switch (type)
+        {
+            case BandParams::FilterType::LowShelf:
+            case BandParams::FilterType::HighShelf:
+            {
+                // As makeLowShelf / makeHighShelf: the shelf slope term is sin (w0) sqrt (A) / Q
+                const double sign  = type == BandParams::FilterType::LowShelf ? 1.0 : -1.0;
+                const double beta  = sinW0 * std::sqrt (A) / static_cast<double> (q);
+                const double amc   = (A - 1.0) * cosW0;
+                b0 = A * ((A + 1.0) - sign * amc + beta);
+                b1 = 2.0 * sign * A * ((A - 1.0) - sign * (A + 1.0) * cosW0);
+                b2 = A * ((A + 1.0) - sign * amc - beta);
+                a0 = (A + 1.0) + sign * amc + beta;
+                a1 = -2.0 * sign * ((A - 1.0) + sign * (A + 1.0) * cosW0);
+                a2 = (A + 1.0) + sign * amc - beta;
                 break;
+            }
             case BandParams::FilterType::Peak:
-                coeffs.add (juce::dsp::IIR::Coefficients<float>::makePeakFilter (
-                    sampleRate, params.frequency, params.q, juce::Decibels::decibelsToGain (gainDB)));
-                break;
-            case BandParams::FilterType::HighShelf:
-                coeffs.add (juce::dsp::IIR::Coefficients<float>::makeHighShelf (
-                    sampleRate, params.frequency, params.q, juce::Decibels::decibelsToGain (gainDB)));
+                b0 = 1.0 + alpha * A;  b1 = -2.0 * cosW0;  b2 = 1.0 - alpha * A;
+                a0 = 1.0 + alpha / A;  a1 = b1;            a2 = 1.0 - alpha / A;
                 break;
             case BandParams::FilterType::LowCut:
                 // High-pass filter (cuts low frequencies) — gain not applicable
-                coeffs.add (juce::dsp::IIR::Coefficients<float>::makeHighPass (
-                    sampleRate, params.frequency, params.q));
+                b0 = 0.5 * (1.0 + cosW0);  b1 = -(1.0 + cosW0);  b2 = b0;
+                a0 = 1.0 + alpha;          a1 = -2.0 * cosW0;    a2 = 1.0 - alpha;
                 break;
             case BandParams::FilterType::HighCut:
                 // Low-pass filter (cuts high frequencies) — gain not applicable
-                coeffs.add (juce::dsp::IIR::Coefficients<float>::makeLowPass (
-                    sampleRate, params.frequency, params.q));
+                b0 = 0.5 * (1.0 - cosW0);  b1 = 1.0 - cosW0;     b2 = b0;
+                a0 = 1.0 + alpha;          a1 = -2.0 * cosW0;    a2 = 1.0 - alpha;
                 break;
             case BandParams::FilterType::Notch:
-            {
-                // Standard biquad notch: b0=1, b1=-2cos(w0), b2=1, a0=1+alpha, a1=-2cos(w0), a2=1-alpha
-                float w0    = juce::MathConstants<float>::twoPi * params.frequency / static_cast<float>(sampleRate);
-                float cosW0 = std::cos(w0);
-                float alpha = std::sin(w0) / (2.0f * params.q);
-                coeffs.add (new juce::dsp::IIR::Coefficients<float> (
-                    1.0f, -2.0f * cosW0, 1.0f,
-                    1.0f + alpha, -2.0f * cosW0, 1.0f - alpha));
+                b0 = 1.0;                  b1 = -2.0 * cosW0;    b2 = 1.0;
+                a0 = 1.0 + alpha;          a1 = b1;              a2 = 1.0 - alpha;
                 break;
-            }
             case BandParams::FilterType::BandPass:
-                coeffs.add (juce::dsp::IIR::Coefficients<float>::makeBandPass (
-                    sampleRate, params.frequency, params.q));
+                b0 = alpha;                b1 = 0.0;             b2 = -alpha;
+                a0 = 1.0 + alpha;          a1 = -2.0 * cosW0;    a2 = 1.0 - alpha;
                 break;
         }
 
-        if (coeffs.size() > 0)
+        const double scale = 1.0 / a0;
+        return { static_cast<float> (b0 * scale), static_cast<float> (b1 * scale), static_cast<float> (b2 * scale),
+                 static_cast<float> (a1 * scale), static_cast<float> (a2 * scale) };
+    }
+
+    // designCoefficients as a juce::dsp::IIR::Coefficients for the display curve and match
+    // EQ. Allocates: not for the audio thread.
+    static juce::dsp::IIR::Coefficients<float>::Ptr makeCoefficients (BandParams::FilterType type, double sr,
+                                                                      float freq, float q, float gainDB)
+    {
+        const auto c = designCoefficients (type, sr, freq, q, gainDB);
+        return new juce::dsp::IIR::Coefficients<float> (c.b0, c.b1, c.b2, 1.0f, c.a1, c.a2);
+    }
+
+private:
+    void updateTailLength()
+    {
+        if (! params.enabled || sampleRate <= 0.0)
         {
-            for (auto& f : filters)
-                *f.state = *coeffs[0];
+            filterTailSamples = 0;
+            idleTailSamples   = 0;
+            return;
         }
+
+        // A static identity band is elided and contributes no ringing
+        filterTailSamples = (! params.dynamicOn && isIdentityGain (params.gain))
+                              ? 0 : computeFilterTailSamples (designCoefficients (params.type, sampleRate, params.frequency,
+                                                                                  params.q, params.gain), sampleRate);
+        idleTailSamples   = params.dynamicOn ? juce::jmax (filterTailSamples, computeReleaseSamples (sampleRate, params.releaseMs))
+                                             : filterTailSamples;
     }
 
-    void updateSidechainFilter()
+    // Samples for a full-scale detector envelope to release below silenceFloor. The
+    // DetectorBank's release decays by exp (-1) per releaseMs.
+    static int computeReleaseSamples (double sr, float releaseMs)
     {
-        if (sampleRate <= 0.0)
-            return;
+        const double samples = sr * releaseMs * 0.001;
+        if (samples <= 0.0)
+            return 0;
+        return static_cast<int> (juce::jmin (static_cast<double> (std::numeric_limits<int>::max()),
+                                             std::ceil (-std::log (static_cast<double> (silenceFloor)) * samples)));
+    }
+
+    // Decay time of a biquad's impulse response, from its largest pole radius
+    static int computeFilterTailSamples (const BiquadKernels::Coefficients& c, double sr)
+    {
+        const int maxTail = static_cast<int> (sr * 10.0);   // unstable / near-unit poles: cap at 10 s
+
+        // Normalised (a0 = 1): the poles are the roots of z^2 + a1 z + a2
+        const double a1   = static_cast<double> (c.a1);
+        const double a2   = static_cast<double> (c.a2);
+        const double disc = a1 * a1 - 4.0 * a2;
 
-        auto coeffs = juce::dsp::IIR::Coefficients<float>::makeBandPass (
-            sampleRate, params.frequency, params.q);
-        *sidechainFilter.state = *coeffs;
+        double radius;
+        if (disc < 0.0)
+        {
+            radius = std::sqrt (a2);   // complex-conjugate pair: |p|^2 = a2
+        }
+        else
+        {
+            const double root = std::sqrt (disc);
+            radius = 0.5 * juce::jmax (std::abs (-a1 + root), std::abs (-a1 - root));
+        }
+
+        if (radius < 1.0e-9)
+            return maxOrder;
+        if (radius >= 1.0)
+            return maxTail;
+
+        const double tail = std::log (static_cast<double> (silenceFloor)) / std::log (radius);
+        return juce::jmin (maxTail, static_cast<int> (std::ceil (tail)) + maxOrder);
     }
 
     BandParams params;
+    bool paramsInitialised = false;
     double sampleRate = 44100.0;
-    EnvelopeFollower envelopeFollower;
 
-    // Stereo processing filter (duplicated for L/R via ProcessorDuplicator)
-    using Filter = juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                                   juce::dsp::IIR::Coefficients<float>>;
-    std::array<Filter, 1> filters; // Single second-order section
+    // Smoothed filter-shape parameters (log domain for frequency and Q)
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> smoothedFreq, smoothedQ;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear>         smoothedGain;
 
-    Filter sidechainFilter;
+    // Inputs of the coefficients currently loaded into the kernel
+    struct AppliedCoefficients
+    {
+        BandParams::FilterType type = BandParams::FilterType::Peak;
+        float freq = 0.0f, q = 0.0f, gainDB = 0.0f;
+        bool valid = false;
+    };
+    AppliedCoefficients appliedCoeffs;
+
+    // Processing section: one coefficient set, per-channel state, and the kernel for the
+    // current type's coefficient structure
+    BiquadKernels::Coefficients coefficients;
+    std::vector<BiquadKernels::State> filterStates;
+    BiquadKernels::Kernel kernel = BiquadKernels::get (BiquadKernels::Structure::general);
+
+    int filterTailSamples = 0;
+    int idleTailSamples   = 0;
+
+    juce::AudioBuffer<float> dryBuffer;
+    bool elided         = false;
+    bool elisionEnabled = true;
 
     std::atomic<float> gainReductionDB { 0.0f };
 };
@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    FFTBackend.h
+    FFT engine interface: bundled SimdFFT or juce::dsp::FFT, chosen at runtime
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SimdFFT.h"
+
+//==============================================================================
+// One interface over the FFT engines, so the analyzers (and any future
+// convolution path) do not depend on which engine JUCE was built with.
+//
+// Layouts follow juce::dsp::FFT: real transforms work in place on 2 * N floats
+// and only bins 0..N/2 are produced or read; inverse transforms scale by 1 / N.
+//==============================================================================
+class FFTBackend
+{
+public:
+    enum class Engine
+    {
+        automatic,   // juce::dsp::FFT if it wraps a native library, otherwise bundled
+        bundled,     // SimdFFT
+        juce         // juce::dsp::FFT
+    };
+
+    using Complex = std::complex<float>;
+
+    virtual ~FFTBackend() = default;
+
+    static std::unique_ptr<FFTBackend> create (int order, Engine engine = Engine::automatic);
+
+    // True if juce::dsp::FFT uses a platform library (vDSP, MKL or FFTW) rather than
+    // its own fallback engine, which is several times slower than SimdFFT
+    static constexpr bool juceUsesNativeEngine() noexcept
+    {
+       #if JUCE_MAC || JUCE_IOS || JUCE_DSP_USE_INTEL_MKL || JUCE_DSP_USE_STATIC_FFTW || JUCE_DSP_USE_SHARED_FFTW
+        return true;
+       #else
+        return false;
+       #endif
+    }
+
+    int getSize() const noexcept { return size; }
+
+    virtual Engine getEngine() const noexcept = 0;
+    virtual juce::String getName() const = 0;
+
+    // Forward complex transform of getSize() points (in and out may alias)
+    virtual void perform (const Complex* in, Complex* out) noexcept = 0;
+
+    // getSize() samples -> interleaved complex bins 0..N/2
+    virtual void performRealOnlyForwardTransform (float* data) noexcept = 0;
+
+    // Interleaved complex bins 0..N/2 -> getSize() samples
+    virtual void performRealOnlyInverseTransform (float* data) noexcept = 0;
+
+    // getSize() samples -> magnitudes of bins 0..N/2
+    virtual void performFrequencyOnlyForwardTransform (float* data) noexcept
+    {
+        performRealOnlyForwardTransform (data);
+
+        // Bin i occupies data[2i], data[2i + 1], so writing data[i] in order is safe
+        const auto* bins = reinterpret_cast<const Complex*> (data);
+        for (int i = 0; i <= size / 2; ++i)
+            data[i] = std::sqrt (std::norm (bins[i]));
+    }
+
+protected:
+    explicit FFTBackend (int order) : size (1 << order) {}
+
+    const int size;
+};
+
+//==============================================================================
+class BundledFFTBackend final : public FFTBackend
+{
+public:
+    explicit BundledFFTBackend (int order) : FFTBackend (order), fft (order) {}
+
+    Engine getEngine() const noexcept override { return Engine::bundled; }
+    juce::String getName() const override      { return juce::String ("Stockham (auto-vectorised, ") + fft.getCodePath() + ")"; }
+
+    void perform (const Complex* in, Complex* out) noexcept override
+    {
+        fft.perform (in, out);
+    }
+
+    void performRealOnlyForwardTransform (float* data) noexcept override
+    {
+        fft.performReal (data, reinterpret_cast<Complex*> (data));
+    }
+
+    void performRealOnlyInverseTransform (float* data) noexcept override
+    {
+        fft.performRealInverse (reinterpret_cast<const Complex*> (data), data);
+    }
+
+private:
+    SimdFFT fft;
+};
+
+//==============================================================================
+class JuceFFTBackend final : public FFTBackend
+{
+public:
+    explicit JuceFFTBackend (int order)
+        : FFTBackend (order), fft (order), scratch (static_cast<size_t> (1 << order))
+    {
+    }
+
+    Engine getEngine() const noexcept override { return Engine::juce; }
+    juce::String getName() const override      { return juceUsesNativeEngine() ? "JUCE (native)" : "JUCE (fallback)"; }
+
+    void perform (const Complex* in, Complex* out) noexcept override
+    {
+        // juce::dsp::FFT needs distinct input and output arrays
+        if (in == out)
+        {
+            std::copy (in, in + size, scratch.begin());
+            in = scratch.data();
+        }
+
+        fft.perform (in, out, false);
+    }
+
+    void performRealOnlyForwardTransform (float* data) noexcept override
+    {
+        fft.performRealOnlyForwardTransform (data, true);
+    }
+
+    void performRealOnlyInverseTransform (float* data) noexcept override
+    {
+        fft.performRealOnlyInverseTransform (data);
+    }
+
+    void performFrequencyOnlyForwardTransform (float* data) noexcept override
+    {
+        fft.performFrequencyOnlyForwardTransform (data, true);
+    }
+
+private:
+    juce::dsp::FFT fft;
+    std::vector<Complex> scratch;
+};
+
+//==============================================================================
+inline std::unique_ptr<FFTBackend> FFTBackend::create (int order, Engine engine)
+{
+    if (engine == Engine::automatic)
+        engine = juceUsesNativeEngine() ? Engine::juce : Engine::bundled;
+
+    if (engine == Engine::juce)
+        return std::make_unique<JuceFFTBackend> (order);
+
+    return std::make_unique<BundledFFTBackend> (order);
+}
@@ -0,0 +1,179 @@
+/*
+  ==============================================================================
+
+    GainReductionHistory.h
+    Lock-free per-band gain-reduction history (min/max/mean at a fixed rate)
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// The audio thread folds the gain reduction of every band into fixed-length
+// frames (1 ms by default) and appends {min, max, mean} to a per-band ring.
+// The GUI reads any range of recent frames without locking: every value is an
+// atomic and reads are validated against the write counter afterwards, so a
+// frame overwritten mid-read is discarded instead of returned torn.
+//
+// A band's ring (about 24 kB) is allocated by allocate() the first time the
+// band is activated and kept until destruction, so the rings in use follow the
+// active band count rather than NumBands. Rings must be allocated before the
+// band count that includes them is published to the audio thread.
+//==============================================================================
+template <int NumBands>
+class GainReductionHistory
+{
+public:
+    static constexpr int framesPerSecond = 1000;
+    static constexpr int capacity        = 2048;   // frames per band (~2 s), power of two
+
+    struct Frame
+    {
+        float minDB  = 0.0f;
+        float maxDB  = 0.0f;
+        float meanDB = 0.0f;
+    };
+
+    GainReductionHistory() = default;
+
+    //==============================================================================
+    // Message thread: creates the rings of bands 0..numBands - 1 that do not exist yet
+    void allocate (int numBands)
+    {
+        for (int i = 0; i < juce::jmin (numBands, NumBands); ++i)
+            if (bands[static_cast<size_t> (i)] == nullptr)
+                bands[static_cast<size_t> (i)] = std::make_unique<BandRing>();
+    }
+
+    //==============================================================================
+    // Audio thread
+    //==============================================================================
+    void prepare (double sampleRate)
+    {
+        samplesPerFrame = juce::jmax (1, juce::roundToInt (sampleRate / framesPerSecond));
+
+        for (auto& band : bands)
+            if (band != nullptr)
+                band->acc = {};
+    }
+
+    // Append a gain reduction value held constant for numSamples samples
+    void push (int bandIndex, float grDB, int numSamples) noexcept
+    {
+        if (! juce::isPositiveAndBelow (bandIndex, NumBands) || bands[static_cast<size_t> (bandIndex)] == nullptr)
+            return;
+
+        auto& band = *bands[static_cast<size_t> (bandIndex)];
+        auto& acc  = band.acc;
+
+        while (numSamples > 0)
+        {
+            const int take = juce::jmin (numSamples, samplesPerFrame - acc.count);
+
+            if (acc.count == 0)
+            {
+                acc.minDB = grDB;
+                acc.maxDB = grDB;
+                acc.sumDB = 0.0f;
+            }
+            else
+            {
+                acc.minDB = juce::jmin (acc.minDB, grDB);
+                acc.maxDB = juce::jmax (acc.maxDB, grDB);
+            }
+
+            acc.sumDB  += grDB * static_cast<float> (take);
+            acc.count  += take;
+            numSamples -= take;
+
+            if (acc.count >= samplesPerFrame)
+            {
+                const auto index = band.writeCount.load (std::memory_order_relaxed);
+                auto& slot = band.frames[static_cast<size_t> (index & (capacity - 1))];
+                slot.minDB.store  (acc.minDB, std::memory_order_relaxed);
+                slot.maxDB.store  (acc.maxDB, std::memory_order_relaxed);
+                slot.meanDB.store (acc.sumDB / static_cast<float> (acc.count), std::memory_order_relaxed);
+                band.writeCount.store (index + 1, std::memory_order_release);
+                acc.count = 0;
+            }
+        }
+    }
+
+    //==============================================================================
+    // Any thread
+    //==============================================================================
+    // Total number of frames written for a band since construction
+    juce::int64 getWriteCount (int bandIndex) const noexcept
+    {
+        if (! juce::isPositiveAndBelow (bandIndex, NumBands) || bands[static_cast<size_t> (bandIndex)] == nullptr)
+            return 0;
+        return bands[static_cast<size_t> (bandIndex)]->writeCount.load (std::memory_order_acquire);
+    }
+
+    // Copy frames [firstFrame, firstFrame + maxFrames) that are still in the ring (at most the
+    // newest capacity - 1). firstFrame is advanced past frames that were already overwritten;
+    // returns the number copied.
+    int readFrames (int bandIndex, juce::int64& firstFrame, Frame* dest, int maxFrames) const noexcept
+    {
+        if (! juce::isPositiveAndBelow (bandIndex, NumBands) || maxFrames <= 0
+            || bands[static_cast<size_t> (bandIndex)] == nullptr)
+            return 0;
+
+        const auto& band = *bands[static_cast<size_t> (bandIndex)];
+        const auto end   = band.writeCount.load (std::memory_order_acquire);
+
+        // The writer fills slot (writeCount & mask) before publishing the new count, so the
+        // oldest of the last `capacity` frames may already be mid-overwrite: skip it
+        firstFrame = juce::jlimit (juce::jmax (juce::int64 (0), end + 1 - capacity), end, firstFrame);
+        const int num = static_cast<int> (juce::jmin (static_cast<juce::int64> (maxFrames), end - firstFrame));
+
+        for (int i = 0; i < num; ++i)
+        {
+            const auto& slot = band.frames[static_cast<size_t> ((firstFrame + i) & (capacity - 1))];
+            dest[i].minDB  = slot.minDB.load  (std::memory_order_relaxed);
+            dest[i].maxDB  = slot.maxDB.load  (std::memory_order_relaxed);
+            dest[i].meanDB = slot.meanDB.load (std::memory_order_relaxed);
+        }
+
+        // Drop any leading frames the writer lapped while we were copying
+        std::atomic_thread_fence (std::memory_order_acquire);
+        const auto endAfter = band.writeCount.load (std::memory_order_relaxed);
+        const auto lapped   = static_cast<int> (juce::jlimit (juce::int64 (0), static_cast<juce::int64> (num),
+                                                              endAfter + 1 - capacity - firstFrame));
+        if (lapped > 0)
+            std::copy (dest + lapped, dest + num, dest);
+
+        firstFrame += num;
+        return num - lapped;
+    }
+
+private:
+    struct AtomicFrame
+    {
+        std::atomic<float> minDB  { 0.0f };
+        std::atomic<float> maxDB  { 0.0f };
+        std::atomic<float> meanDB { 0.0f };
+    };
+
+    // Audio-thread-only partial frame
+    struct Accumulator
+    {
+        float minDB = 0.0f, maxDB = 0.0f, sumDB = 0.0f;
+        int   count = 0;
+    };
+
+    struct BandRing
+    {
+        std::array<AtomicFrame, capacity> frames;
+        std::atomic<juce::int64> writeCount { 0 };
+        Accumulator acc;
+    };
+
+    std::array<std::unique_ptr<BandRing>, NumBands> bands;
+    int samplesPerFrame = 44;
+
+    JUCE_DECLARE_NON_COPYABLE (GainReductionHistory)
+};
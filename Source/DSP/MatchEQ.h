@@ -0,0 +1,651 @@
+/*
+  ==============================================================================
+
+    MatchEQ.h
+    Long-term spectrum capture and match-EQ band fitting
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BiquadResponse.h"
+#include "DynamicEQBand.h"
+#include "FFTBackend.h"
+#include "FastMath.h"
+
+//==============================================================================
+// A long-term spectrum on the fixed match grid: 1/12 octave from 20 Hz to
+// 20.48 kHz. Each point is the mean power of the bins within +-1/24 octave, so
+// spectra from any FFT size or sample rate (live analyzer, audio file) compare
+// point by point. Points above Nyquist, or more than floorDB below the loudest
+// point, get weight 0 and are ignored by the fit.
+//==============================================================================
+struct MatchSpectrum
+{
+    static constexpr float minFreqHz = 20.0f;
+    static constexpr int pointsPerOctave = 12;
+    static constexpr int numPoints = 10 * pointsPerOctave + 1;
+    static constexpr float floorDB = -80.0f;   // relative to the loudest point
+
+    std::array<float, numPoints> db {};
+    std::array<float, numPoints> weight {};
+
+    static double getFrequency (int point) noexcept
+    {
+        return minFreqHz * std::exp2 (static_cast<double> (point) / pointsPerOctave);
+    }
+
+    bool isValid() const noexcept
+    {
+        return std::any_of (weight.begin(), weight.end(), [] (float w) { return w > 0.0f; });
+    }
+
+    // power[k] is the mean linear power of bin k, centred on k * binHz
+    static MatchSpectrum fromBinPower (const double* power, int numBins, double binHz)
+    {
+        MatchSpectrum s;
+        if (numBins < 2 || binHz <= 0.0)
+            return s;
+
+        const double halfWidth = std::exp2 (0.5 / pointsPerOctave);
+        const double topHz = binHz * (numBins - 1);
+        float loudest = -1000.0f;
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const double f = getFrequency (i);
+            if (f * halfWidth >= 0.95 * topHz)
+                continue;
+
+            int lo = static_cast<int> (std::ceil (f / halfWidth / binHz));
+            int hi = static_cast<int> (std::floor (f * halfWidth / binHz));
+            if (hi < lo)
+                lo = hi = juce::roundToInt (f / binHz);
+            lo = juce::jlimit (1, numBins - 1, lo);
+            hi = juce::jlimit (lo, numBins - 1, hi);
+
+            double sum = 0.0;
+            for (int k = lo; k <= hi; ++k)
+                sum += power[k];
+
+            const double mean = sum / (hi - lo + 1);
+            s.db[static_cast<size_t> (i)] = mean > 0.0 ? static_cast<float> (10.0 * std::log10 (mean)) : -1000.0f;
+            s.weight[static_cast<size_t> (i)] = 1.0f;
+            loudest = juce::jmax (loudest, s.db[static_cast<size_t> (i)]);
+        }
+
+        for (size_t i = 0; i < s.db.size(); ++i)
+            if (s.db[i] < loudest + floorDB)
+                s.weight[i] = 0.0f;
+
+        return s;
+    }
+
+    // Mean power spectrum of the first maxSeconds of an audio file (channels summed).
+    // Blocking: call from a background thread. Returns an invalid spectrum on failure.
+    static MatchSpectrum fromFile (const juce::File& file, double maxSeconds = 600.0)
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+        std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (file));
+        if (reader == nullptr || reader->sampleRate <= 0.0)
+            return {};
+
+        constexpr int order = 13;
+        constexpr int size = 1 << order;
+        constexpr int hop = size / 2;
+
+        auto fft = FFTBackend::create (order);
+        std::vector<float> window (size), frame (size, 0.0f), work (2 * size);
+        std::vector<double> power (size / 2 + 1, 0.0);
+        juce::dsp::WindowingFunction<float>::fillWindowingTables (window.data(), size,
+                                                                  juce::dsp::WindowingFunction<float>::hann, false);
+
+        const int numChannels = juce::jlimit (1, 2, static_cast<int> (reader->numChannels));
+        juce::AudioBuffer<float> block (numChannels, hop);
+        const auto length = juce::jmin (reader->lengthInSamples,
+                                        static_cast<juce::int64> (maxSeconds * reader->sampleRate));
+        int numFrames = 0;
+
+        for (juce::int64 pos = 0; pos + hop <= length; pos += hop)
+        {
+            reader->read (&block, 0, hop, pos, true, numChannels > 1);
+
+            std::copy (frame.begin() + hop, frame.end(), frame.begin());
+            juce::FloatVectorOperations::copy (frame.data() + (size - hop), block.getReadPointer (0), hop);
+            for (int ch = 1; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::add (frame.data() + (size - hop), block.getReadPointer (ch), hop);
+
+            if (pos + hop < size)
+                continue;   // first window not full yet
+
+            juce::FloatVectorOperations::multiply (work.data(), frame.data(), window.data(), size);
+            fft->performFrequencyOnlyForwardTransform (work.data());
+            for (size_t k = 0; k < power.size(); ++k)
+                power[k] += static_cast<double> (work[k]) * work[k];
+            ++numFrames;
+        }
+
+        if (numFrames == 0)
+            return {};
+
+        return fromBinPower (power.data(), static_cast<int> (power.size()), reader->sampleRate / size);
+    }
+};
+
+//==============================================================================
+// Accumulates analyzer frames (normalised 0..1 over minDB..minDB + dbRange, as
+// produced by SpectrumAnalyzer::processFFT) as per-bin power sums, for any
+// capture length. A change of bin count or sample rate restarts the capture.
+// Frames are added on the analysis worker; the GUI reads the result. Both lock.
+//==============================================================================
+class SpectrumCapture
+{
+public:
+    void add (const std::vector<float>& frame, double sampleRate, float minDB = -100.0f, float dbRange = 100.0f)
+    {
+        const juce::ScopedLock sl (lock);
+        const int n = static_cast<int> (frame.size());
+
+        if (n != static_cast<int> (powerSum.size()) || sampleRate != captureSampleRate)
+        {
+            powerSum.assign (frame.size(), 0.0);
+            scratch.resize (frame.size());
+            captureSampleRate = sampleRate;
+            numFrames = 0;
+        }
+
+        // dB = minDB + v * dbRange -> power = 2^(dB * log2(10) / 10)
+        constexpr float log2Of10Over10 = 0.33219281f;
+        juce::FloatVectorOperations::copyWithMultiply (scratch.data(), frame.data(), dbRange * log2Of10Over10, n);
+        juce::FloatVectorOperations::add (scratch.data(), minDB * log2Of10Over10, n);
+        FastMath::exp2 (scratch.data(), scratch.data(), n);
+
+        for (int k = 0; k < n; ++k)
+            powerSum[static_cast<size_t> (k)] += scratch[static_cast<size_t> (k)];
+
+        ++numFrames;
+    }
+
+    void reset()
+    {
+        const juce::ScopedLock sl (lock);
+        powerSum.clear();
+        numFrames = 0;
+    }
+
+    int getNumFrames() const
+    {
+        const juce::ScopedLock sl (lock);
+        return numFrames;
+    }
+
+    MatchSpectrum getSpectrum() const
+    {
+        const juce::ScopedLock sl (lock);
+        if (numFrames == 0)
+            return {};
+
+        // The analyzer's bins are k * sampleRate / fftSize, fftSize = 2 * numBins
+        const int numBins = static_cast<int> (powerSum.size());
+        return MatchSpectrum::fromBinPower (powerSum.data(), numBins, captureSampleRate / (2.0 * numBins));
+    }
+
+private:
+    juce::CriticalSection lock;
+    std::vector<double> powerSum;
+    std::vector<float> scratch;
+    double captureSampleRate = 0.0;
+    int numFrames = 0;
+};
+
+//==============================================================================
+// Fits numBands bands (frequency, gain, Q and shelf / peak type) so the summed
+// band response matches reference - source on the match grid.
+//
+// Levenberg-Marquardt over (log2 freq, gain dB, log2 Q) per band. The model is
+// the closed-form biquad response from BiquadResponse; since band responses add
+// in dB, each Jacobian column only re-evaluates its own band. Each band type
+// layout (low shelf or peak at the bottom, high shelf or peak at the top) is
+// seeded greedily at the largest remaining deviation and fitted; the lowest
+// error wins. The cost grows faster than the square of the band count: a fit takes
+// about 6 ms at 8 bands, 30 ms at 16 and 180 ms at 32 on one desktop core
+// (DynamicEQBenchmark), so callers run it off the message thread.
+//
+// The overall level difference is removed from the target first: matching
+// loudness is not the EQ's job.
+//==============================================================================
+class MatchEQFitter
+{
+public:
+    using FilterType = BandParams::FilterType;
+
+    static constexpr int maxIterations = 100;
+    static constexpr float maxGainDB = 24.0f;    // the gain parameter's range
+    static constexpr double gainPenalty = 0.05;  // per dB^2: keeps bands that do nothing at 0 dB
+
+    struct Result
+    {
+        std::vector<BandParams> bands;   // shape fields only; enabled, static
+        float rmsErrorDB = 0.0f;         // weighted, over the valid grid points
+        int iterations = 0;
+        double milliseconds = 0.0;
+    };
+
+    explicit MatchEQFitter (double sampleRate)
+    {
+        std::array<double, MatchSpectrum::numPoints> frequencies;
+        for (int i = 0; i < MatchSpectrum::numPoints; ++i)
+            frequencies[static_cast<size_t> (i)] = MatchSpectrum::getFrequency (i);
+
+        response.prepare (frequencies.data(), MatchSpectrum::numPoints, sampleRate);
+        maxLogFreq = std::log2 (juce::jmin (20000.0, 0.45 * sampleRate));
+    }
+
+    // Target in dB (reference - source, level removed, clamped to the gain range) and its
+    // weights; false if the two spectra share no valid points
+    static bool computeTarget (const MatchSpectrum& reference, const MatchSpectrum& source,
+                               std::array<float, MatchSpectrum::numPoints>& target,
+                               std::array<float, MatchSpectrum::numPoints>& weight)
+    {
+        double sum = 0.0, weightSum = 0.0;
+        for (size_t i = 0; i < target.size(); ++i)
+        {
+            weight[i] = reference.weight[i] * source.weight[i];
+            target[i] = weight[i] > 0.0f ? reference.db[i] - source.db[i] : 0.0f;
+            sum += weight[i] * target[i];
+            weightSum += weight[i];
+        }
+
+        if (weightSum <= 0.0)
+            return false;
+
+        const auto level = static_cast<float> (sum / weightSum);
+        for (auto& t : target)
+            t = juce::jlimit (-maxGainDB, maxGainDB, t - level);
+
+        return true;
+    }
+
+    Result fit (const MatchSpectrum& reference, const MatchSpectrum& source, int numBands)
+    {
+        const double start = juce::Time::getMillisecondCounterHiRes();
+        Result best;
+
+        if (numBands < 1 || ! computeTarget (reference, source, target, weight))
+            return best;
+
+        double bestCost = std::numeric_limits<double>::max();
+
+        for (int layout = 0; layout < 4; ++layout)
+        {
+            const bool lowShelf  = (layout & 1) != 0;
+            const bool highShelf = (layout & 2) != 0;
+            if (static_cast<int> (lowShelf) + static_cast<int> (highShelf) > numBands)
+                continue;
+
+            int iterations = 0;
+            const double cost = fitLayout (numBands, lowShelf, highShelf, iterations);
+            best.iterations += iterations;
+
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                best.bands = toBandParams();
+            }
+        }
+
+        double weightSum = 0.0;
+        for (auto w : weight)
+            weightSum += w;
+
+        // Report the pure match error, without the gain penalty
+        setParameters (best.bands);
+        evaluateAll (x, bandDB);
+        double error = 0.0;
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const double e = model (i) - target[static_cast<size_t> (i)];
+            error += weight[static_cast<size_t> (i)] * e * e;
+        }
+
+        best.rmsErrorDB = static_cast<float> (std::sqrt (error / juce::jmax (1.0e-9, weightSum)));
+        best.milliseconds = juce::Time::getMillisecondCounterHiRes() - start;
+        return best;
+    }
+
+private:
+    static constexpr int numPoints = MatchSpectrum::numPoints;
+    static constexpr int paramsPerBand = 3;   // log2 freq, gain, log2 Q
+
+    //==============================================================================
+    double fitLayout (int numBands, bool lowShelf, bool highShelf, int& iterations)
+    {
+        types.assign (static_cast<size_t> (numBands), FilterType::Peak);
+        if (lowShelf)  types.front() = FilterType::LowShelf;
+        if (highShelf) types.back()  = FilterType::HighShelf;
+
+        seed();
+
+        const int numParams = numBands * paramsPerBand;
+        const int numResiduals = numPoints + numBands;
+        std::vector<double> residual, trialX, trialResidual, step;
+        std::vector<double> jacobian (static_cast<size_t> (numResiduals * numParams));
+        std::vector<double> normal (static_cast<size_t> (numParams * numParams));
+        std::vector<double> gradient (static_cast<size_t> (numParams));
+        std::vector<std::vector<float>> trialDB;
+        std::vector<float> perturbed (static_cast<size_t> (numPoints));
+
+        evaluateAll (x, bandDB);
+        double cost = computeResiduals (x, bandDB, residual);
+        double lambda = 1.0e-3;
+
+        for (iterations = 0; iterations < maxIterations; ++iterations)
+        {
+            // Forward-difference Jacobian; only band b's response depends on its parameters
+            std::fill (jacobian.begin(), jacobian.end(), 0.0);
+            for (int b = 0; b < numBands; ++b)
+            {
+                for (int j = 0; j < paramsPerBand; ++j)
+                {
+                    const int p = b * paramsPerBand + j;
+                    auto xp = x;
+                    xp[static_cast<size_t> (p)] += differenceStep[j];
+                    evaluateBand (b, xp, perturbed.data());
+
+                    const auto& base = bandDB[static_cast<size_t> (b)];
+                    for (int i = 0; i < numPoints; ++i)
+                        jacobian[static_cast<size_t> (i * numParams + p)]
+                            = std::sqrt (weight[static_cast<size_t> (i)])
+                              * (perturbed[static_cast<size_t> (i)] - base[static_cast<size_t> (i)]) / differenceStep[j];
+                }
+
+                jacobian[static_cast<size_t> ((numPoints + b) * numParams + b * paramsPerBand + 1)] = std::sqrt (gainPenalty);
+            }
+
+            // Normal equations J^T J, J^T r
+            for (int r = 0; r < numParams; ++r)
+            {
+                for (int c = r; c < numParams; ++c)
+                {
+                    double sum = 0.0;
+                    for (int i = 0; i < numResiduals; ++i)
+                        sum += jacobian[static_cast<size_t> (i * numParams + r)] * jacobian[static_cast<size_t> (i * numParams + c)];
+                    normal[static_cast<size_t> (r * numParams + c)] = normal[static_cast<size_t> (c * numParams + r)] = sum;
+                }
+
+                double g = 0.0;
+                for (int i = 0; i < numResiduals; ++i)
+                    g += jacobian[static_cast<size_t> (i * numParams + r)] * residual[static_cast<size_t> (i)];
+                gradient[static_cast<size_t> (r)] = g;
+            }
+
+            // Raise the damping until a step lowers the cost
+            bool improved = false;
+            double trialCost = cost;
+            while (lambda < 1.0e10)
+            {
+                if (solveDamped (normal, gradient, lambda, numParams, step))
+                {
+                    trialX = x;
+                    for (int p = 0; p < numParams; ++p)
+                        trialX[static_cast<size_t> (p)] -= step[static_cast<size_t> (p)];
+                    clampParameters (trialX);
+
+                    evaluateAll (trialX, trialDB);
+                    trialCost = computeResiduals (trialX, trialDB, trialResidual);
+
+                    if (trialCost < cost)
+                    {
+                        improved = true;
+                        break;
+                    }
+                }
+
+                lambda *= 4.0;
+            }
+
+            if (! improved)
+                break;
+
+            const double gain = cost - trialCost;
+            std::swap (x, trialX);
+            std::swap (bandDB, trialDB);
+            std::swap (residual, trialResidual);
+            cost = trialCost;
+            lambda = juce::jmax (1.0e-7, lambda / 3.0);
+
+            if (gain < 1.0e-6 * cost)
+                break;
+        }
+
+        return cost;
+    }
+
+    // Shelves take the mean deviation of the bottom / top two octaves; each peak then
+    // goes to the largest deviation the bands so far leave
+    void seed()
+    {
+        const int numBands = static_cast<int> (types.size());
+        x.assign (static_cast<size_t> (numBands * paramsPerBand), 0.0);
+        std::vector<float> remaining (target.begin(), target.end());
+        std::vector<float> db (static_cast<size_t> (numPoints));
+
+        auto placeBand = [&] (int b, double freq, double gainDB, double q)
+        {
+            x[static_cast<size_t> (b * paramsPerBand)]     = std::log2 (freq);
+            x[static_cast<size_t> (b * paramsPerBand + 1)] = gainDB;
+            x[static_cast<size_t> (b * paramsPerBand + 2)] = std::log2 (q);
+            clampParameters (x);
+            evaluateBand (b, x, db.data());
+            for (size_t i = 0; i < remaining.size(); ++i)
+                remaining[i] -= db[i];
+        };
+
+        auto meanOver = [&] (int begin, int end)
+        {
+            double sum = 0.0, w = 0.0;
+            for (int i = juce::jmax (0, begin); i < juce::jmin (numPoints, end); ++i)
+            {
+                sum += weight[static_cast<size_t> (i)] * remaining[static_cast<size_t> (i)];
+                w += weight[static_cast<size_t> (i)];
+            }
+            return w > 0.0 ? sum / w : 0.0;
+        };
+
+        const int twoOctaves = 2 * MatchSpectrum::pointsPerOctave;
+        for (int b = 0; b < numBands; ++b)
+        {
+            if (types[static_cast<size_t> (b)] == FilterType::LowShelf)
+                placeBand (b, 120.0, meanOver (0, twoOctaves), 0.707);
+            else if (types[static_cast<size_t> (b)] == FilterType::HighShelf)
+                placeBand (b, 8000.0, meanOver (numPoints - twoOctaves, numPoints), 0.707);
+        }
+
+        for (int b = 0; b < numBands; ++b)
+        {
+            if (types[static_cast<size_t> (b)] != FilterType::Peak)
+                continue;
+
+            int peak = 0;
+            float largest = -1.0f;
+            for (int i = 0; i < numPoints; ++i)
+            {
+                const float d = weight[static_cast<size_t> (i)] * std::abs (remaining[static_cast<size_t> (i)]);
+                if (d > largest)
+                {
+                    largest = d;
+                    peak = i;
+                }
+            }
+
+            placeBand (b, MatchSpectrum::getFrequency (peak), remaining[static_cast<size_t> (peak)], 1.4);
+        }
+    }
+
+    //==============================================================================
+    void evaluateBand (int b, const std::vector<double>& params, float* destDB) const
+    {
+        const auto* p = params.data() + b * paramsPerBand;
+        auto coeffs = DynamicEQBand::makeCoefficients (types[static_cast<size_t> (b)], response.getSampleRate(),
+                                                       static_cast<float> (std::exp2 (p[0])),
+                                                       static_cast<float> (std::exp2 (p[2])),
+                                                       static_cast<float> (p[1]));
+        response.getMagnitudeDB (*coeffs, destDB);
+    }
+
+    void evaluateAll (const std::vector<double>& params, std::vector<std::vector<float>>& dest) const
+    {
+        dest.resize (types.size());
+        for (size_t b = 0; b < types.size(); ++b)
+        {
+            dest[b].resize (static_cast<size_t> (numPoints));
+            evaluateBand (static_cast<int> (b), params, dest[b].data());
+        }
+    }
+
+    double model (int i) const
+    {
+        double sum = 0.0;
+        for (const auto& db : bandDB)
+            sum += db[static_cast<size_t> (i)];
+        return sum;
+    }
+
+    // Weighted residuals plus the gain penalty; returns the sum of squares
+    double computeResiduals (const std::vector<double>& params, const std::vector<std::vector<float>>& db,
+                             std::vector<double>& residual) const
+    {
+        const int numBands = static_cast<int> (types.size());
+        residual.resize (static_cast<size_t> (numPoints + numBands));
+        double cost = 0.0;
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            double sum = 0.0;
+            for (const auto& band : db)
+                sum += band[static_cast<size_t> (i)];
+
+            const double r = std::sqrt (weight[static_cast<size_t> (i)]) * (sum - target[static_cast<size_t> (i)]);
+            residual[static_cast<size_t> (i)] = r;
+            cost += r * r;
+        }
+
+        for (int b = 0; b < numBands; ++b)
+        {
+            const double r = std::sqrt (gainPenalty) * params[static_cast<size_t> (b * paramsPerBand + 1)];
+            residual[static_cast<size_t> (numPoints + b)] = r;
+            cost += r * r;
+        }
+
+        return cost;
+    }
+
+    // Solves (A + lambda diag(A)) step = g by Cholesky; false if not positive definite
+    static bool solveDamped (const std::vector<double>& a, const std::vector<double>& g, double lambda,
+                             int n, std::vector<double>& step)
+    {
+        std::vector<double> l (static_cast<size_t> (n * n), 0.0);
+        step.assign (static_cast<size_t> (n), 0.0);
+
+        for (int r = 0; r < n; ++r)
+        {
+            for (int c = 0; c <= r; ++c)
+            {
+                double sum = a[static_cast<size_t> (r * n + c)];
+                if (r == c)
+                    sum += lambda * a[static_cast<size_t> (r * n + r)] + 1.0e-9;
+
+                for (int k = 0; k < c; ++k)
+                    sum -= l[static_cast<size_t> (r * n + k)] * l[static_cast<size_t> (c * n + k)];
+
+                if (r == c)
+                {
+                    if (sum <= 0.0)
+                        return false;
+                    l[static_cast<size_t> (r * n + r)] = std::sqrt (sum);
+                }
+                else
+                {
+                    l[static_cast<size_t> (r * n + c)] = sum / l[static_cast<size_t> (c * n + c)];
+                }
+            }
+        }
+
+        // L y = g, then L^T step = y
+        for (int r = 0; r < n; ++r)
+        {
+            double sum = g[static_cast<size_t> (r)];
+            for (int k = 0; k < r; ++k)
+                sum -= l[static_cast<size_t> (r * n + k)] * step[static_cast<size_t> (k)];
+            step[static_cast<size_t> (r)] = sum / l[static_cast<size_t> (r * n + r)];
+        }
+
+        for (int r = n - 1; r >= 0; --r)
+        {
+            double sum = step[static_cast<size_t> (r)];
+            for (int k = r + 1; k < n; ++k)
+                sum -= l[static_cast<size_t> (k * n + r)] * step[static_cast<size_t> (k)];
+            step[static_cast<size_t> (r)] = sum / l[static_cast<size_t> (r * n + r)];
+        }
+
+        return true;
+    }
+
+    void clampParameters (std::vector<double>& params) const
+    {
+        for (size_t b = 0; b < types.size(); ++b)
+        {
+            auto* p = params.data() + b * paramsPerBand;
+            const bool shelf = types[b] != FilterType::Peak;
+
+            p[0] = juce::jlimit (std::log2 (static_cast<double> (MatchSpectrum::minFreqHz)), maxLogFreq, p[0]);
+            p[1] = juce::jlimit (-static_cast<double> (maxGainDB), static_cast<double> (maxGainDB), p[1]);
+            p[2] = shelf ? juce::jlimit (std::log2 (0.4), std::log2 (1.0), p[2])
+                         : juce::jlimit (std::log2 (0.2), std::log2 (10.0), p[2]);
+        }
+    }
+
+    std::vector<BandParams> toBandParams() const
+    {
+        std::vector<BandParams> bands (types.size());
+        for (size_t b = 0; b < bands.size(); ++b)
+        {
+            const auto* p = x.data() + b * paramsPerBand;
+            bands[b].type      = types[b];
+            bands[b].frequency = static_cast<float> (std::exp2 (p[0]));
+            bands[b].gain      = static_cast<float> (p[1]);
+            bands[b].q         = static_cast<float> (std::exp2 (p[2]));
+            bands[b].enabled   = true;
+            bands[b].dynamicOn = false;
+        }
+        return bands;
+    }
+
+    void setParameters (const std::vector<BandParams>& bands)
+    {
+        types.resize (bands.size());
+        x.resize (bands.size() * paramsPerBand);
+        for (size_t b = 0; b < bands.size(); ++b)
+        {
+            types[b] = bands[b].type;
+            x[b * paramsPerBand]     = std::log2 (static_cast<double> (bands[b].frequency));
+            x[b * paramsPerBand + 1] = static_cast<double> (bands[b].gain);
+            x[b * paramsPerBand + 2] = std::log2 (static_cast<double> (bands[b].q));
+        }
+    }
+
+    static constexpr double differenceStep[paramsPerBand] = { 0.01, 0.05, 0.01 };   // octaves, dB, octaves
+
+    BiquadResponse response;
+    double maxLogFreq = std::log2 (20000.0);
+
+    std::array<float, numPoints> target {}, weight {};
+    std::vector<FilterType> types;
+    std::vector<double> x;                       // paramsPerBand per band
+    std::vector<std::vector<float>> bandDB;      // each band's response at x
+
+    JUCE_DECLARE_NON_COPYABLE (MatchEQFitter)
+};
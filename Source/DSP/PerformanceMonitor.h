@@ -0,0 +1,255 @@
+/*
+  ==============================================================================
+
+    PerformanceMonitor.h
+    Lock-free processBlock timing statistics (ns/sample histogram, p99, overruns)
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Per-instance processing cost monitor.
+//
+// The audio thread is the only writer: it records one entry per processBlock
+// (and optionally one per band). Every counter is an atomic updated with a
+// relaxed load/store pair instead of a read-modify-write, so recording costs a
+// handful of plain stores. The GUI thread reads snapshots at any time.
+//==============================================================================
+template <int NumBands>
+class PerformanceMonitor
+{
+public:
+    // Histogram of ns/sample on a log2 scale, 4 buckets per octave: 1 ns .. 65 us
+    static constexpr int bucketsPerOctave = 4;
+    static constexpr int numBuckets       = 16 * bucketsPerOctave;
+
+    struct Snapshot
+    {
+        juce::uint64 numBlocks        = 0;
+        juce::uint64 numOverruns      = 0;      // blocks slower than the real-time deadline
+        float meanNsPerSample         = 0.0f;
+        float maxNsPerSample          = 0.0f;
+        float p99NsPerSample          = 0.0f;
+        float cpuLoad                 = 0.0f;   // smoothed elapsed / deadline (1.0 = 100%)
+        bool  perBandTiming           = false;
+        std::array<float, NumBands> bandNsPerSample {};
+    };
+
+    PerformanceMonitor()
+        : nsPerTick (1.0e9 / static_cast<double> (juce::Time::getHighResolutionTicksPerSecond()))
+    {
+        clearCounters();
+    }
+
+    //==============================================================================
+    // Audio thread
+    //==============================================================================
+    static juce::int64 now() noexcept { return juce::Time::getHighResolutionTicks(); }
+
+    void recordBlock (juce::int64 startTicks, int numSamples, double sampleRate) noexcept
+    {
+        if (resetRequested.exchange (false, std::memory_order_acquire))
+            clearCounters();
+
+        if (numSamples <= 0 || sampleRate <= 0.0)
+            return;
+
+        const double elapsedNs   = static_cast<double> (now() - startTicks) * nsPerTick;
+        const double budgetNs    = 1.0e9 * static_cast<double> (numSamples) / sampleRate;
+        const float  nsPerSample = static_cast<float> (elapsedNs / static_cast<double> (numSamples));
+
+        increment (buckets[static_cast<size_t> (bucketForValue (nsPerSample))]);
+        increment (numBlocks);
+        add (totalNs, elapsedNs);
+        add (totalSamples, static_cast<double> (numSamples));
+
+        if (elapsedNs > budgetNs)
+            increment (numOverruns);
+
+        if (nsPerSample > maxNsPerSample.load (std::memory_order_relaxed))
+            maxNsPerSample.store (nsPerSample, std::memory_order_relaxed);
+
+        const float load = static_cast<float> (elapsedNs / budgetNs);
+        const float prev = cpuLoad.load (std::memory_order_relaxed);
+        cpuLoad.store (prev + loadSmoothing * (load - prev), std::memory_order_relaxed);
+    }
+
+    void recordBand (int bandIndex, juce::int64 startTicks, int numSamples) noexcept
+    {
+        if (bandIndex < 0 || bandIndex >= NumBands)
+            return;
+
+        const auto b = static_cast<size_t> (bandIndex);
+        add (bandNs[b], static_cast<double> (now() - startTicks) * nsPerTick);
+        add (bandSamples[b], static_cast<double> (numSamples));
+    }
+
+    // RAII helper timing one processBlock
+    class ScopedBlockTimer
+    {
+    public:
+        ScopedBlockTimer (PerformanceMonitor& m, int samples, double sr) noexcept
+            : monitor (m), startTicks (now()), numSamples (samples), sampleRate (sr) {}
+
+        ~ScopedBlockTimer() { monitor.recordBlock (startTicks, numSamples, sampleRate); }
+
+    private:
+        PerformanceMonitor& monitor;
+        juce::int64 startTicks;
+        int numSamples;
+        double sampleRate;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedBlockTimer)
+    };
+
+    //==============================================================================
+    // Any thread
+    //==============================================================================
+    bool isPerBandTimingEnabled() const noexcept { return perBandTiming.load (std::memory_order_relaxed); }
+    void setPerBandTimingEnabled (bool shouldTime) noexcept { perBandTiming.store (shouldTime); }
+
+    // Counters are cleared by the audio thread at the start of its next block
+    void reset() noexcept { resetRequested.store (true, std::memory_order_release); }
+
+    Snapshot getSnapshot() const
+    {
+        Snapshot s;
+        s.numBlocks      = numBlocks.load (std::memory_order_relaxed);
+        s.numOverruns    = numOverruns.load (std::memory_order_relaxed);
+        s.maxNsPerSample = maxNsPerSample.load (std::memory_order_relaxed);
+        s.cpuLoad        = cpuLoad.load (std::memory_order_relaxed);
+        s.perBandTiming  = isPerBandTimingEnabled();
+
+        const double samples = totalSamples.load (std::memory_order_relaxed);
+        if (samples > 0.0)
+            s.meanNsPerSample = static_cast<float> (totalNs.load (std::memory_order_relaxed) / samples);
+
+        // p99: upper edge of the bucket holding the 99th percentile block
+        std::array<juce::uint64, numBuckets> counts {};
+        juce::uint64 total = 0;
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            counts[i] = buckets[i].load (std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        if (total > 0)
+        {
+            const auto target = total - total / 100;
+            juce::uint64 running = 0;
+            for (int i = 0; i < numBuckets; ++i)
+            {
+                running += counts[static_cast<size_t> (i)];
+                if (running >= target)
+                {
+                    s.p99NsPerSample = juce::jmin (bucketUpperEdge (i), s.maxNsPerSample);
+                    break;
+                }
+            }
+        }
+
+        for (size_t b = 0; b < static_cast<size_t> (NumBands); ++b)
+        {
+            const double bandSmp = bandSamples[b].load (std::memory_order_relaxed);
+            if (bandSmp > 0.0)
+                s.bandNsPerSample[b] = static_cast<float> (bandNs[b].load (std::memory_order_relaxed) / bandSmp);
+        }
+
+        return s;
+    }
+
+    // Plain-text report for export (summary + histogram + per-band costs)
+    juce::String createReport (const juce::String& title) const
+    {
+        const auto s = getSnapshot();
+        juce::String r;
+        r << title << juce::newLine
+          << "Blocks:            " << juce::String (static_cast<juce::int64> (s.numBlocks)) << juce::newLine
+          << "Over budget:       " << juce::String (static_cast<juce::int64> (s.numOverruns)) << juce::newLine
+          << "CPU load:          " << juce::String (s.cpuLoad * 100.0f, 2) << " %" << juce::newLine
+          << "Mean ns/sample:    " << juce::String (s.meanNsPerSample, 2) << juce::newLine
+          << "p99 ns/sample:     " << juce::String (s.p99NsPerSample, 2) << juce::newLine
+          << "Max ns/sample:     " << juce::String (s.maxNsPerSample, 2) << juce::newLine
+          << juce::newLine << "Histogram (ns/sample upper edge : blocks)" << juce::newLine;
+
+        for (int i = 0; i < numBuckets; ++i)
+        {
+            const auto count = buckets[static_cast<size_t> (i)].load (std::memory_order_relaxed);
+            if (count > 0)
+                r << "  " << juce::String (bucketUpperEdge (i), 2).paddedLeft (' ', 10)
+                  << " : " << juce::String (static_cast<juce::int64> (count)) << juce::newLine;
+        }
+
+        if (s.perBandTiming)
+        {
+            r << juce::newLine << "Per-band mean ns/sample" << juce::newLine;
+            for (int b = 0; b < NumBands; ++b)
+                if (s.bandNsPerSample[static_cast<size_t> (b)] > 0.0f)   // skip bands that never ran
+                    r << "  Band " << juce::String (b + 1).paddedLeft (' ', 2) << " : "
+                      << juce::String (s.bandNsPerSample[static_cast<size_t> (b)], 2) << juce::newLine;
+        }
+
+        return r;
+    }
+
+private:
+    static constexpr float loadSmoothing = 0.05f;
+
+    static int bucketForValue (float nsPerSample) noexcept
+    {
+        if (nsPerSample <= 1.0f)
+            return 0;
+        const int idx = static_cast<int> (std::log2 (nsPerSample) * static_cast<float> (bucketsPerOctave));
+        return juce::jlimit (0, numBuckets - 1, idx);
+    }
+
+    static float bucketUpperEdge (int bucket) noexcept
+    {
+        return std::exp2 (static_cast<float> (bucket + 1) / static_cast<float> (bucketsPerOctave));
+    }
+
+    // Single-writer updates: no locked read-modify-write needed
+    template <typename T>
+    static void increment (std::atomic<T>& a) noexcept { a.store (a.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+    static void add (std::atomic<double>& a, double v) noexcept { a.store (a.load (std::memory_order_relaxed) + v, std::memory_order_relaxed); }
+
+    void clearCounters() noexcept
+    {
+        for (auto& b : buckets)
+            b.store (0, std::memory_order_relaxed);
+        for (size_t b = 0; b < static_cast<size_t> (NumBands); ++b)
+        {
+            bandNs[b].store (0.0, std::memory_order_relaxed);
+            bandSamples[b].store (0.0, std::memory_order_relaxed);
+        }
+        numBlocks.store (0, std::memory_order_relaxed);
+        numOverruns.store (0, std::memory_order_relaxed);
+        totalNs.store (0.0, std::memory_order_relaxed);
+        totalSamples.store (0.0, std::memory_order_relaxed);
+        maxNsPerSample.store (0.0f, std::memory_order_relaxed);
+        cpuLoad.store (0.0f, std::memory_order_relaxed);
+    }
+
+    const double nsPerTick;
+
+    std::array<std::atomic<juce::uint64>, numBuckets> buckets;
+    std::array<std::atomic<double>, NumBands> bandNs;
+    std::array<std::atomic<double>, NumBands> bandSamples;
+
+    std::atomic<juce::uint64> numBlocks   { 0 };
+    std::atomic<juce::uint64> numOverruns { 0 };
+    std::atomic<double> totalNs           { 0.0 };
+    std::atomic<double> totalSamples      { 0.0 };
+    std::atomic<float>  maxNsPerSample    { 0.0f };
+    std::atomic<float>  cpuLoad           { 0.0f };
+
+    std::atomic<bool> perBandTiming  { false };
+    std::atomic<bool> resetRequested { false };
+
+    JUCE_DECLARE_NON_COPYABLE (PerformanceMonitor)
+};
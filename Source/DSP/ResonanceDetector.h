@@ -0,0 +1,232 @@
+/*
+  ==============================================================================
+
+    ResonanceDetector.h
+    Finds narrow, persistent spectral peaks and suggests dynamic Peak bands
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Looks for resonances in successive analyzer frames (normalised 0..1 over
+// minDB..minDB + dbRange, as produced by SpectrumAnalyzer::processFFT):
+//
+//   1. the frame is reduced to a 1/48-octave grid (loudest bin per point)
+//   2. the envelope is the mean level over +-1/3 octave; prominence is the
+//      level above it
+//   3. level and prominence are averaged over timeConstantSeconds, so only
+//      peaks that persist stand out
+//   4. local maxima of the averaged prominence above minProminenceDB become
+//      suggestions: Q from the width at half prominence
+//
+// The bands' detectors measure the broadband input peak, not this analyzer's
+// per-bin level, so a suggested band's threshold comes from getBandThresholdDB:
+// the detectors' long-term level plus a margin. Steady material then stays below
+// it, and the band only cuts when the signal rises above its usual level.
+//
+// Each frame costs one pass over the bins plus a few over the fixed grid, with
+// no allocation once the bin count is known, so the cost per frame is bounded
+// by the largest FFT size. Runs on the analysis thread.
+//==============================================================================
+class ResonanceDetector
+{
+public:
+    static constexpr float minFreqHz = 20.0f;
+    static constexpr int pointsPerOctave = 48;
+    static constexpr int numPoints = 10 * pointsPerOctave + 1;   // 20 Hz .. 20.48 kHz
+    static constexpr int envelopeHalfWidth = pointsPerOctave / 3;
+
+    static constexpr float timeConstantSeconds = 3.0f;
+    static constexpr float warmUpSeconds = 1.0f;
+    static constexpr float minProminenceDB = 4.0f;
+    static constexpr float minLevelDB = -80.0f;
+    static constexpr int maxSuggestions = 8;
+    static constexpr int minSeparation = pointsPerOctave / 6;    // between suggestions
+    static constexpr float thresholdMarginDB = 6.0f;             // above the detectors' usual level
+
+    struct Suggestion
+    {
+        float frequency = 1000.0f;
+        float q = 4.0f;
+        float prominenceDB = 0.0f;
+    };
+
+    // Threshold for a suggested band, from the long-term level its detector sees
+    // (DetectorBank::getLongTermLevelDB), within the threshold parameter's range
+    static float getBandThresholdDB (float detectorLevelDB) noexcept
+    {
+        return juce::jlimit (-60.0f, 0.0f, detectorLevelDB + thresholdMarginDB);
+    }
+
+    static float getFrequency (int point) noexcept
+    {
+        return minFreqHz * std::exp2 (static_cast<float> (point) / pointsPerOctave);
+    }
+
+    // Restarts the averages at the next frame
+    void reset() { resetRequested.store (true); }
+
+    //==============================================================================
+    // Analysis thread. Returns true when the suggestions were updated.
+    bool process (const std::vector<float>& frame, double sampleRate, float frameSeconds,
+                  float minDB = -100.0f, float dbRange = 100.0f)
+    {
+        const int numBins = static_cast<int> (frame.size());
+        if (numBins < 2 || sampleRate <= 0.0)
+            return false;
+
+        if (resetRequested.exchange (false) || numBins != tableBins || sampleRate != tableSampleRate)
+            restart (numBins, sampleRate);
+
+        // 1. Loudest bin per grid point, in dB
+        for (int i = 0; i < numGridPoints; ++i)
+        {
+            const auto& range = binRanges[static_cast<size_t> (i)];
+            float peak = 0.0f;
+            for (int k = range.first; k <= range.second; ++k)
+                peak = juce::jmax (peak, frame[static_cast<size_t> (k)]);
+            level[static_cast<size_t> (i)] = minDB + peak * dbRange;
+        }
+
+        // 2. Envelope: running mean over +-envelopeHalfWidth, clamped at the ends
+        double sum = 0.0;
+        int begin = 0, end = 0;
+        for (int i = 0; i < numGridPoints; ++i)
+        {
+            const int newBegin = juce::jmax (0, i - envelopeHalfWidth);
+            const int newEnd = juce::jmin (numGridPoints, i + envelopeHalfWidth + 1);
+            for (; end < newEnd; ++end)     sum += level[static_cast<size_t> (end)];
+            for (; begin < newBegin; ++begin) sum -= level[static_cast<size_t> (begin)];
+
+            const auto envelope = static_cast<float> (sum / (end - begin));
+            prominence[static_cast<size_t> (i)] = level[static_cast<size_t> (i)] - envelope;
+        }
+
+        // 3. Long-term averages
+        elapsedSeconds += frameSeconds;
+        const float a = firstFrame ? 1.0f : 1.0f - std::exp (-frameSeconds / timeConstantSeconds);
+        firstFrame = false;
+
+        for (int i = 0; i < numGridPoints; ++i)
+        {
+            const auto n = static_cast<size_t> (i);
+            averageLevel[n] += a * (level[n] - averageLevel[n]);
+            averageProminence[n] += a * (prominence[n] - averageProminence[n]);
+        }
+
+        if (elapsedSeconds < warmUpSeconds)
+            return false;
+
+        findSuggestions();
+        return true;
+    }
+
+    const std::vector<Suggestion>& getSuggestions() const noexcept { return suggestions; }
+
+private:
+    //==============================================================================
+    void restart (int numBins, double sampleRate)
+    {
+        tableBins = numBins;
+        tableSampleRate = sampleRate;
+
+        // Analyzer bins are k * sampleRate / fftSize, fftSize = 2 * numBins. Points past
+        // Nyquist are left out.
+        const double binHz = sampleRate / (2.0 * numBins);
+        const double halfWidth = std::exp2 (0.5 / pointsPerOctave);
+        numGridPoints = 0;
+
+        binRanges.resize (static_cast<size_t> (numPoints));
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const double f = getFrequency (i);
+            if (f * halfWidth >= 0.95 * binHz * (numBins - 1))
+                break;
+
+            int lo = static_cast<int> (std::ceil (f / halfWidth / binHz));
+            int hi = static_cast<int> (std::floor (f * halfWidth / binHz));
+            if (hi < lo)
+                lo = hi = juce::roundToInt (f / binHz);
+
+            lo = juce::jlimit (1, numBins - 1, lo);
+            binRanges[static_cast<size_t> (i)] = { lo, juce::jlimit (lo, numBins - 1, hi) };
+            ++numGridPoints;
+        }
+
+        for (auto* v : { &level, &prominence, &averageLevel, &averageProminence })
+            v->assign (static_cast<size_t> (numPoints), 0.0f);
+
+        candidates.reserve (static_cast<size_t> (numPoints));
+        suggestions.reserve (static_cast<size_t> (maxSuggestions));
+        suggestions.clear();
+        elapsedSeconds = 0.0f;
+        firstFrame = true;
+    }
+
+    void findSuggestions()
+    {
+        // Local maxima of the persistent prominence, strongest first
+        candidates.clear();
+        for (int i = 1; i < numGridPoints - 1; ++i)
+        {
+            const auto n = static_cast<size_t> (i);
+            if (averageProminence[n] >= minProminenceDB && averageLevel[n] >= minLevelDB
+                && averageProminence[n] >= averageProminence[n - 1] && averageProminence[n] > averageProminence[n + 1])
+                candidates.push_back (i);
+        }
+
+        std::sort (candidates.begin(), candidates.end(),
+                   [this] (int x, int y) { return averageProminence[static_cast<size_t> (x)] > averageProminence[static_cast<size_t> (y)]; });
+
+        suggestions.clear();
+        for (int peak : candidates)
+        {
+            if (static_cast<int> (suggestions.size()) == maxSuggestions)
+                break;
+
+            const auto freq = getFrequency (peak);
+            const bool tooClose = std::any_of (suggestions.begin(), suggestions.end(), [freq] (const Suggestion& s)
+            {
+                return std::abs (std::log2 (s.frequency / freq)) * pointsPerOctave < minSeparation;
+            });
+            if (tooClose)
+                continue;
+
+            // Width at half prominence -> bandwidth in octaves -> Q
+            const float half = 0.5f * averageProminence[static_cast<size_t> (peak)];
+            int left = peak, right = peak;
+            while (left > 0 && averageProminence[static_cast<size_t> (left - 1)] > half)
+                --left;
+            while (right < numGridPoints - 1 && averageProminence[static_cast<size_t> (right + 1)] > half)
+                ++right;
+
+            const float octaves = static_cast<float> (right - left + 1) / pointsPerOctave;
+            const float ratio = std::exp2 (octaves);
+
+            Suggestion s;
+            s.frequency = freq;
+            s.q = juce::jlimit (1.0f, 10.0f, std::sqrt (ratio) / (ratio - 1.0f));
+            s.prominenceDB = averageProminence[static_cast<size_t> (peak)];
+            suggestions.push_back (s);
+        }
+    }
+
+    std::atomic<bool> resetRequested { false };
+
+    int tableBins = 0;
+    double tableSampleRate = 0.0;
+    int numGridPoints = 0;                          // points below Nyquist
+    std::vector<std::pair<int, int>> binRanges;     // inclusive bin range per grid point
+
+    std::vector<float> level, prominence;           // this frame
+    std::vector<float> averageLevel, averageProminence;
+    float elapsedSeconds = 0.0f;
+    bool firstFrame = true;
+
+    std::vector<int> candidates;
+    std::vector<Suggestion> suggestions;
+};
@@ -0,0 +1,212 @@
+/*
+  ==============================================================================
+
+    SimdFFT.h
+    Bundled split-format Stockham FFT (complex and real) with AVX2 dispatch
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <complex>
+#include "SimdFFTPasses.h"
+
+// AVX2 + FMA build of the passes, picked at runtime on x86:
+//   GCC / Clang - a wrapper with a target attribute, in this header
+//   MSVC        - SimdFFT_AVX2.cpp, compiled with /arch:AVX2 (MSVC has no per-function
+//                 target attribute)
+#if JUCE_INTEL && (JUCE_GCC || JUCE_CLANG)
+ #define DYNAMICEQ_SIMDFFT_AVX2_DISPATCH 1
+ #define DYNAMICEQ_SIMDFFT_AVX2_ATTRIBUTE 1
+#elif JUCE_INTEL && JUCE_MSVC
+ #define DYNAMICEQ_SIMDFFT_AVX2_DISPATCH 1
+ #define DYNAMICEQ_SIMDFFT_AVX2_ATTRIBUTE 0
+#else
+ #define DYNAMICEQ_SIMDFFT_AVX2_DISPATCH 0
+ #define DYNAMICEQ_SIMDFFT_AVX2_ATTRIBUTE 0
+#endif
+
+//==============================================================================
+// Power-of-two FFT with no external dependencies.
+//
+// Data is held as separate real / imaginary arrays, and the Stockham ordering
+// (radix-4 passes, plus one radix-2 pass for odd orders) writes every pass
+// contiguously into a second buffer, with no bit reversal. So the inner loops
+// are plain unit-stride float loops that the compiler vectorises for the target
+// ISA: the baseline build (SSE2 on x86; elsewhere whatever the compiler makes of
+// it, there are no intrinsics), and an AVX2 + FMA build of the same passes
+// picked at runtime on x86 CPUs that support it. The passes themselves live in
+// SimdFFTPasses.h, so the MSVC build can compile them in their own translation
+// unit with AVX2 enabled.
+//
+// A real transform of size N runs as a complex transform of size N / 2 on the
+// even / odd samples, followed by one split pass. Forward transforms are
+// unscaled; inverse transforms scale by 1 / N, as juce::dsp::FFT does.
+//==============================================================================
+class SimdFFT
+{
+public:
+    using Complex = std::complex<float>;
+
+    explicit SimdFFT (int order)
+        : size (1 << order)
+    {
+        jassert (order >= 2);
+
+        const auto n = static_cast<size_t> (size);
+        cosTable.resize (n);
+        sinTable.resize (n);
+
+        // Full circle of W_N^k = exp(-j 2 pi k / N); radix-4 passes index up to 3N / 4
+        for (size_t k = 0; k < n; ++k)
+        {
+            const double angle = juce::MathConstants<double>::twoPi * static_cast<double> (k) / size;
+            cosTable[k] = static_cast<float> (std::cos (angle));
+            sinTable[k] = static_cast<float> (-std::sin (angle));
+        }
+
+        for (auto* buffer : { &re0, &im0, &re1, &im1 })
+            buffer->resize (n);
+
+       #if DYNAMICEQ_SIMDFFT_AVX2_DISPATCH
+        if (juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3())
+            passes = &runPassesAVX2;
+       #endif
+    }
+
+    int getSize() const noexcept { return size; }
+
+    // Build of the passes chosen for this CPU
+    const char* getCodePath() const noexcept
+    {
+       #if DYNAMICEQ_SIMDFFT_AVX2_DISPATCH
+        if (passes == &runPassesAVX2)
+            return "AVX2 + FMA";
+        return "SSE2";
+       #else
+        return "baseline";
+       #endif
+    }
+
+    //==============================================================================
+    // Forward complex transform of size N (out may alias in)
+    void perform (const Complex* in, Complex* out) noexcept
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            re0[static_cast<size_t> (i)] = in[i].real();
+            im0[static_cast<size_t> (i)] = in[i].imag();
+        }
+
+        const auto result = transform (size, 1);
+
+        for (int i = 0; i < size; ++i)
+            out[i] = { result.re[i], result.im[i] };
+    }
+
+    // Forward real transform of N samples: writes bins 0..N/2 (N/2 + 1 values)
+    void performReal (const float* in, Complex* out) noexcept
+    {
+        const int m = size / 2;
+        for (int i = 0; i < m; ++i)
+        {
+            re0[static_cast<size_t> (i)] = in[2 * i];
+            im0[static_cast<size_t> (i)] = in[2 * i + 1];
+        }
+
+        const auto z = transform (m, 2);
+
+        // X[k] = E[k] + W_N^k O[k], with E / O the spectra of the even / odd samples:
+        //   E = (Z[k] + conj Z[m-k]) / 2,  O = -j (Z[k] - conj Z[m-k]) / 2
+        out[0] = { z.re[0] + z.im[0], 0.0f };
+        out[m] = { z.re[0] - z.im[0], 0.0f };
+
+        for (int k = 1; k < m; ++k)
+        {
+            const float ar = z.re[k], ai = z.im[k];
+            const float br = z.re[m - k], bi = -z.im[m - k];
+            const float er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+            const float or_ = 0.5f * (ai - bi), oi = -0.5f * (ar - br);
+            const float wr = cosTable[static_cast<size_t> (k)], wi = sinTable[static_cast<size_t> (k)];
+            out[k] = { er + wr * or_ - wi * oi, ei + wr * oi + wi * or_ };
+        }
+    }
+
+    // Inverse real transform: reads bins 0..N/2, writes N samples scaled by 1 / N
+    void performRealInverse (const Complex* in, float* out) noexcept
+    {
+        const int m = size / 2;
+
+        // Undo the split: E = (X[k] + conj X[m-k]) / 2, O = conj(W_N^k) (X[k] - conj X[m-k]) / 2,
+        // Z = E + j O. The inverse runs as a forward transform of conj Z.
+        for (int k = 0; k < m; ++k)
+        {
+            const float ar = in[k].real(), ai = in[k].imag();
+            const float br = in[m - k].real(), bi = -in[m - k].imag();
+            const float er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+            const float dr = 0.5f * (ar - br), di = 0.5f * (ai - bi);
+            const float wr = cosTable[static_cast<size_t> (k)], wi = -sinTable[static_cast<size_t> (k)];
+            const float or_ = dr * wr - di * wi, oi = dr * wi + di * wr;
+            re0[static_cast<size_t> (k)] = er - oi;
+            im0[static_cast<size_t> (k)] = -(ei + or_);
+        }
+
+        const auto z = transform (m, 2);
+        const float scale = 1.0f / static_cast<float> (m);
+
+        for (int i = 0; i < m; ++i)
+        {
+            out[2 * i]     = z.re[i] * scale;
+            out[2 * i + 1] = -z.im[i] * scale;
+        }
+    }
+
+private:
+    struct Split
+    {
+        const float* re;
+        const float* im;
+    };
+
+    using Buffers = SimdFFTPasses::Buffers;
+
+    using PassesFn = bool (*) (const Buffers&, int, int) noexcept;
+
+    // Complex transform of the first n values of re0 / im0, using every
+    // twiddleStride-th table entry (n * twiddleStride == size)
+    Split transform (int n, int twiddleStride) noexcept
+    {
+        const Buffers b { re0.data(), im0.data(), re1.data(), im1.data(), cosTable.data(), sinTable.data() };
+        const bool inSecond = passes (b, n, twiddleStride);
+        return inSecond ? Split { re1.data(), im1.data() } : Split { re0.data(), im0.data() };
+    }
+
+    static bool runPassesDefault (const Buffers& b, int n, int twiddleStride) noexcept
+    {
+        return SimdFFTPasses::run<SimdFFTPasses::Baseline> (b, n, twiddleStride);
+    }
+
+   #if DYNAMICEQ_SIMDFFT_AVX2_ATTRIBUTE
+    struct AVX2 {};
+
+    __attribute__ ((target ("avx2,fma")))
+    static bool runPassesAVX2 (const Buffers& b, int n, int twiddleStride) noexcept
+    {
+        return SimdFFTPasses::run<AVX2> (b, n, twiddleStride);
+    }
+   #elif DYNAMICEQ_SIMDFFT_AVX2_DISPATCH
+    static bool runPassesAVX2 (const Buffers& b, int n, int twiddleStride) noexcept
+    {
+        return SimdFFTPasses::runAVX2 (b, n, twiddleStride);
+    }
+   #endif
+
+    int size;
+    std::vector<float> cosTable, sinTable;
+    std::vector<float> re0, im0, re1, im1;
+    PassesFn passes = &runPassesDefault;
+
+    JUCE_DECLARE_NON_COPYABLE (SimdFFT)
+};
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    SimdFFTPasses.h
+    The Stockham butterfly passes of SimdFFT, free of any other dependency
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// Deliberately includes nothing and calls no library code: besides SimdFFT.h this
+// is compiled into SimdFFT_AVX2.cpp with AVX2 code generation (MSVC), and any
+// inline function that translation unit emits could be merged by the linker into
+// the baseline code paths, which must run on CPUs without AVX2.
+
+#if defined (__clang__)
+ #define SIMDFFT_PASSES_IVDEP _Pragma ("clang loop vectorize(assume_safety)")
+ #define SIMDFFT_PASSES_INLINE __attribute__ ((always_inline)) inline
+#elif defined (__GNUC__)
+ #define SIMDFFT_PASSES_IVDEP _Pragma ("GCC ivdep")
+ #define SIMDFFT_PASSES_INLINE __attribute__ ((always_inline)) inline
+#elif defined (_MSC_VER)
+ #define SIMDFFT_PASSES_IVDEP __pragma (loop (ivdep))
+ #define SIMDFFT_PASSES_INLINE __forceinline
+#else
+ #define SIMDFFT_PASSES_IVDEP
+ #define SIMDFFT_PASSES_INLINE inline
+#endif
+
+namespace SimdFFTPasses
+{
+    struct Buffers
+    {
+        float* xr; float* xi;   // pass input
+        float* yr; float* yi;   // pass output
+        const float* cosTable;
+        const float* sinTable;
+    };
+
+    // Runs every pass over the first n values of x, ping-ponging between the buffers and
+    // using every twiddleStride-th table entry. Returns true if the result ended up in y.
+    // The Isa tag only makes each instruction set's build a separate function: the AVX2
+    // translation unit instantiates it with a tag of its own, in an anonymous namespace.
+    // Always inlined, so a wrapper with target attributes gets its own ISA (GCC / Clang).
+    template <typename Isa>
+    SIMDFFT_PASSES_INLINE bool run (const Buffers& buffers, int n, int twiddleStride) noexcept
+    {
+        float* xr = buffers.xr; float* xi = buffers.xi;
+        float* yr = buffers.yr; float* yi = buffers.yi;
+        const float* wc = buffers.cosTable;
+        const float* ws = buffers.sinTable;
+        bool inY = false;
+        int s = 1;
+
+        // Radix-4: length n sequences at stride s -> length n / 4 at stride 4s
+        for (; n >= 4; n /= 4, s *= 4)
+        {
+            const int n4 = n / 4;
+
+            for (int p = 0; p < n4; ++p)
+            {
+                const int t = p * s * twiddleStride;
+                const float w1r = wc[t],     w1i = ws[t];
+                const float w2r = wc[2 * t], w2i = ws[2 * t];
+                const float w3r = wc[3 * t], w3i = ws[3 * t];
+
+                const float* ar = xr + s * p;            const float* ai = xi + s * p;
+                const float* br = xr + s * (p + n4);     const float* bi = xi + s * (p + n4);
+                const float* cr = xr + s * (p + 2 * n4); const float* ci = xi + s * (p + 2 * n4);
+                const float* dr = xr + s * (p + 3 * n4); const float* di = xi + s * (p + 3 * n4);
+                float* y0r = yr + s * (4 * p);     float* y0i = yi + s * (4 * p);
+                float* y1r = yr + s * (4 * p + 1); float* y1i = yi + s * (4 * p + 1);
+                float* y2r = yr + s * (4 * p + 2); float* y2i = yi + s * (4 * p + 2);
+                float* y3r = yr + s * (4 * p + 3); float* y3i = yi + s * (4 * p + 3);
+
+                SIMDFFT_PASSES_IVDEP
+                for (int q = 0; q < s; ++q)
+                {
+                    const float apcR = ar[q] + cr[q], apcI = ai[q] + ci[q];
+                    const float amcR = ar[q] - cr[q], amcI = ai[q] - ci[q];
+                    const float bpdR = br[q] + dr[q], bpdI = bi[q] + di[q];
+                    // j (b - d)
+                    const float jbmdR = -(bi[q] - di[q]), jbmdI = br[q] - dr[q];
+
+                    y0r[q] = apcR + bpdR;
+                    y0i[q] = apcI + bpdI;
+
+                    const float u1r = amcR - jbmdR, u1i = amcI - jbmdI;
+                    y1r[q] = u1r * w1r - u1i * w1i;
+                    y1i[q] = u1r * w1i + u1i * w1r;
+
+                    const float u2r = apcR - bpdR, u2i = apcI - bpdI;
+                    y2r[q] = u2r * w2r - u2i * w2i;
+                    y2i[q] = u2r * w2i + u2i * w2r;
+
+                    const float u3r = amcR + jbmdR, u3i = amcI + jbmdI;
+                    y3r[q] = u3r * w3r - u3i * w3i;
+                    y3i[q] = u3r * w3i + u3i * w3r;
+                }
+            }
+
+            float* tr = xr; xr = yr; yr = tr;
+            float* ti = xi; xi = yi; yi = ti;
+            inY = ! inY;
+        }
+
+        // Odd order: one radix-2 pass with unit twiddles (n == 2)
+        if (n == 2)
+        {
+            SIMDFFT_PASSES_IVDEP
+            for (int q = 0; q < s; ++q)
+            {
+                const float aR = xr[q], aI = xi[q], bR = xr[q + s], bI = xi[q + s];
+                yr[q]     = aR + bR;  yi[q]     = aI + bI;
+                yr[q + s] = aR - bR;  yi[q + s] = aI - bI;
+            }
+
+            inY = ! inY;
+        }
+
+        return inY;
+    }
+
+    struct Baseline {};
+
+    // SimdFFT_AVX2.cpp; only built and called on MSVC x86 (see SimdFFT.h)
+    bool runAVX2 (const Buffers& buffers, int n, int twiddleStride) noexcept;
+}
@@ -0,0 +1,27 @@
+/*
+  ==============================================================================
+
+    SimdFFT_AVX2.cpp
+    AVX2 + FMA build of the SimdFFT passes for MSVC (compiled with /arch:AVX2)
+
+  ==============================================================================
+*/
+
+#include "SimdFFTPasses.h"
+
+// Only MSVC on x86 dispatches through here; GCC and Clang build their AVX2 passes
+// with a target attribute in SimdFFT.h, so this file is empty for them. Nothing
+// else may be included: see SimdFFTPasses.h.
+#if defined (_MSC_VER) && ! defined (__clang__) && (defined (_M_X64) || defined (_M_IX86))
+
+namespace
+{
+    struct AVX2 {};
+}
+
+bool SimdFFTPasses::runAVX2 (const Buffers& buffers, int n, int twiddleStride) noexcept
+{
+    return run<AVX2> (buffers, n, twiddleStride);
+}
+
+#endif
@@ -0,0 +1,459 @@
+/*
+  ==============================================================================
+
+    SpectralDynamics.h
+    STFT dynamic EQ: per-bin detection and gain against a threshold curve drawn
+    from the bands
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DynamicEQBand.h"
+#include "FastMath.h"
+#include "FFTBackend.h"
+
+//==============================================================================
+// Spectral processing mode. Audio is cut into fftSize frames with 75% overlap
+// (hop = fftSize / 4), sqrt-Hann windowed on analysis and resynthesis, so the
+// unmodified overlap-add reconstructs the input exactly, delayed by fftSize.
+//
+// Per frame, for every bin:
+//   1. level: channel-averaged power in dB, scaled so a full-scale sine
+//      centred on the bin reads 0 dB
+//   2. detection: attack/release envelope of the level, in dB
+//   3. gain computer: reduction = max (0, env - threshold) * (1 - 1 / ratio)
+//   4. gain smoothing: each bin takes the largest reduction of itself and its
+//      two neighbours - the main lobe of the sqrt-Hann window - so a partial
+//      is scaled as a whole instead of having its lobe reshaped, the main
+//      source of "musical noise"
+//   5. the same gain is applied to every channel (linked stereo)
+//
+// Threshold, ratio and timing per bin come from the enabled dynamic bands:
+// each band covers its bandwidth (shelves extend to the end of the spectrum),
+// bands whose ranges overlap join into one curve interpolated in log
+// frequency, and bins no band covers pass unchanged.
+//
+// Buffers and FFT engines for both sizes are allocated in prepare(); the audio
+// thread only switches between them. The per-bin loops work on flat arrays with
+// selects instead of branches and FastMath for dB conversions, so they vectorise.
+//==============================================================================
+template <int MaxBands>
+class SpectralDynamics
+{
+public:
+    static constexpr int minOrder = 11;    // 2048
+    static constexpr int maxOrder = 12;    // 4096
+    static constexpr int overlap = 4;      // frames per fftSize: 75% overlap
+    static constexpr int maxChannels = 2;
+
+    // One enabled dynamic band and its parameters
+    struct Band
+    {
+        int index = 0;
+        BandParams params;
+    };
+
+    //==============================================================================
+    // Allocates everything the audio thread will need
+    void prepare (double newSampleRate, int newNumChannels)
+    {
+        sampleRate = newSampleRate;
+        numChannels = juce::jlimit (1, maxChannels, newNumChannels);
+
+        const auto maxSize = static_cast<size_t> (1 << maxOrder);
+        const auto maxBins = maxSize / 2 + 1;
+
+        for (int o = minOrder; o <= maxOrder; ++o)
+        {
+            auto& t = tables[static_cast<size_t> (o - minOrder)];
+            const int n = 1 << o;
+            t.fft = FFTBackend::create (o);
+            t.analysisWindow.resize (static_cast<size_t> (n));
+            t.synthesisWindow.resize (static_cast<size_t> (n));
+            t.binOctave.resize (static_cast<size_t> (n / 2 + 1));
+
+            // sqrt of a periodic Hann: analysis * synthesis sums to 2 at 75% overlap,
+            // so the synthesis side carries the 1/2
+            for (int i = 0; i < n; ++i)
+            {
+                const auto w = std::sin (juce::MathConstants<double>::pi * i / n);
+                t.analysisWindow[static_cast<size_t> (i)] = static_cast<float> (w);
+                t.synthesisWindow[static_cast<size_t> (i)] = static_cast<float> (0.5 * w);
+            }
+
+            const double binHz = sampleRate / n;
+            for (int k = 0; k <= n / 2; ++k)
+                t.binOctave[static_cast<size_t> (k)] = static_cast<float> (std::log2 (juce::jmax (0.5, static_cast<double> (k)) * binHz));
+        }
+
+        for (auto& ch : channels)
+        {
+            ch.input.assign (maxSize, 0.0f);
+            ch.accumulator.assign (maxSize, 0.0f);
+            ch.output.assign (maxSize / overlap, 0.0f);
+            ch.work.assign (2 * maxSize, 0.0f);
+        }
+
+        for (auto* v : { &power, &level, &envelope, &reduction, &smoothed, &gain,
+                         &threshold, &slope, &attackCoeff, &releaseCoeff })
+            v->assign (maxBins, 0.0f);
+
+        setOrder (order, true);
+    }
+
+    // Audio thread: switches FFT size without allocating. Restarts the stream when
+    // the size changes.
+    void setOrder (int newOrder, bool force = false)
+    {
+        newOrder = juce::jlimit (minOrder, maxOrder, newOrder);
+        if (newOrder == order && ! force)
+            return;
+
+        order = newOrder;
+        fftSize = 1 << order;
+        hop = fftSize / overlap;
+        numBins = fftSize / 2 + 1;
+        active = &tables[static_cast<size_t> (order - minOrder)];
+        curveNeedsUpdate = true;
+        reset();
+    }
+
+    int getFFTSize() const noexcept { return fftSize; }
+
+    // Input to output delay; the host compensates it
+    int getLatencySamples() const noexcept { return getLatencySamples (order); }
+    static constexpr int getLatencySamples (int fftOrder) noexcept { return 1 << fftOrder; }
+
+    // Samples until the last input has left the overlap-add
+    int getTailSamples() const noexcept { return 2 * fftSize - hop; }
+
+    // Clears the stream and detector state
+    void reset()
+    {
+        for (auto& ch : channels)
+        {
+            std::fill (ch.input.begin(), ch.input.end(), 0.0f);
+            std::fill (ch.accumulator.begin(), ch.accumulator.end(), 0.0f);
+            std::fill (ch.output.begin(), ch.output.end(), 0.0f);
+        }
+
+        std::fill (envelope.begin(), envelope.end(), floorDB);
+        hopPosition = 0;
+
+        for (auto& r : bandReductionDB)
+            r.store (0.0f);
+    }
+
+    // Audio thread: the curve is only rebuilt when a band actually changed
+    void setBands (const Band* newBands, int num)
+    {
+        num = juce::jmin (num, MaxBands);
+        bool changed = curveNeedsUpdate || num != numBands;
+        for (int i = 0; i < num && ! changed; ++i)
+            changed = ! isSameBand (newBands[i], bands[static_cast<size_t> (i)]);
+
+        if (! changed)
+            return;
+
+        for (int i = 0; i < numBands; ++i)
+            bandReductionDB[static_cast<size_t> (bands[static_cast<size_t> (i)].index)].store (0.0f);
+
+        std::copy (newBands, newBands + num, bands.begin());
+        numBands = num;
+        updateCurve();
+    }
+
+    // Largest per-bin reduction inside a band's range, in dB (any thread)
+    float getBandReductionDB (int bandIndex) const
+    {
+        return juce::isPositiveAndBelow (bandIndex, MaxBands) ? bandReductionDB[static_cast<size_t> (bandIndex)].load() : 0.0f;
+    }
+
+    //==============================================================================
+    // Audio thread, in place. Buffers with more channels than prepared leave the
+    // extra channels untouched.
+    void process (juce::AudioBuffer<float>& buffer)
+    {
+        const int numSamples = buffer.getNumSamples();
+        const int chans = juce::jmin (numChannels, buffer.getNumChannels());
+
+        for (int start = 0; start < numSamples;)
+        {
+            const int len = juce::jmin (hop - hopPosition, numSamples - start);
+
+            for (int c = 0; c < chans; ++c)
+            {
+                auto& ch = channels[static_cast<size_t> (c)];
+                float* data = buffer.getWritePointer (c, start);
+
+                juce::FloatVectorOperations::copy (ch.input.data() + fftSize - hop + hopPosition, data, len);
+                juce::FloatVectorOperations::copy (data, ch.output.data() + hopPosition, len);
+            }
+
+            hopPosition += len;
+            start += len;
+
+            if (hopPosition == hop)
+            {
+                processFrame (chans);
+                hopPosition = 0;
+            }
+        }
+    }
+
+private:
+    //==============================================================================
+    static constexpr float floorDB = -200.0f;
+    static constexpr float noCurveDB = 1000.0f;     // threshold of bins no band covers
+    static constexpr float minBandwidthOctaves = 1.0f / 12.0f;
+
+    struct Tables
+    {
+        std::unique_ptr<FFTBackend> fft;
+        std::vector<float> analysisWindow, synthesisWindow;
+        std::vector<float> binOctave;               // log2 of each bin's frequency
+    };
+
+    struct Channel
+    {
+        std::vector<float> input;                   // last fftSize input samples
+        std::vector<float> accumulator;             // overlap-add sum, starting at the next hop
+        std::vector<float> output;                  // finished samples played during this hop
+        std::vector<float> work;                    // 2 * fftSize FFT buffer
+    };
+
+    static bool isSameBand (const Band& a, const Band& b) noexcept
+    {
+        return a.index == b.index && a.params.type == b.params.type
+            && a.params.frequency == b.params.frequency && a.params.q == b.params.q
+            && a.params.threshold == b.params.threshold && a.params.ratio == b.params.ratio
+            && a.params.attackMs == b.params.attackMs && a.params.releaseMs == b.params.releaseMs;
+    }
+
+    //==============================================================================
+    void processFrame (int chans)
+    {
+        const int n = fftSize;
+        const float* analysisWindow = active->analysisWindow.data();
+        const float* synthesisWindow = active->synthesisWindow.data();
+
+        // Analysis, and the channel-averaged power of each bin
+        juce::FloatVectorOperations::fill (power.data(), 1.0e-30f, numBins);   // keeps log2 on normal floats
+        const float channelScale = 1.0f / static_cast<float> (chans);
+
+        for (int c = 0; c < chans; ++c)
+        {
+            auto& ch = channels[static_cast<size_t> (c)];
+            float* work = ch.work.data();
+            juce::FloatVectorOperations::multiply (work, ch.input.data(), analysisWindow, n);
+            active->fft->performRealOnlyForwardTransform (work);
+
+            float* p = power.data();
+            for (int k = 0; k < numBins; ++k)
+                p[k] += channelScale * (work[2 * k] * work[2 * k] + work[2 * k + 1] * work[2 * k + 1]);
+        }
+
+        computeGains();
+
+        // Resynthesis: scale the bins, inverse transform, overlap-add
+        const float* g = gain.data();
+        for (int c = 0; c < chans; ++c)
+        {
+            auto& ch = channels[static_cast<size_t> (c)];
+            float* work = ch.work.data();
+
+            for (int k = 0; k < numBins; ++k)
+            {
+                work[2 * k]     *= g[k];
+                work[2 * k + 1] *= g[k];
+            }
+
+            active->fft->performRealOnlyInverseTransform (work);
+
+            float* acc = ch.accumulator.data();
+            juce::FloatVectorOperations::addWithMultiply (acc, work, synthesisWindow, n);
+
+            // The first hop has all its contributions: it plays during the next hop
+            juce::FloatVectorOperations::copy (ch.output.data(), acc, hop);
+            std::memmove (acc, acc + hop, sizeof (float) * static_cast<size_t> (n - hop));
+            juce::FloatVectorOperations::clear (acc + n - hop, hop);
+
+            float* in = ch.input.data();
+            std::memmove (in, in + hop, sizeof (float) * static_cast<size_t> (n - hop));
+        }
+    }
+
+    void computeGains()
+    {
+        const int nb = numBins;
+        float* lv = level.data();
+        float* env = envelope.data();
+        float* red = reduction.data();
+        float* sm = smoothed.data();
+        const float* thr = threshold.data();
+        const float* sl = slope.data();
+        const float* att = attackCoeff.data();
+        const float* rel = releaseCoeff.data();
+
+        // 1. Level in dB: a sine of amplitude A through the sqrt-Hann window peaks at
+        //    |X| = A * fftSize / pi
+        FastMath::powerToDecibels (lv, power.data(), nb);
+        juce::FloatVectorOperations::add (lv, levelOffsetDB, nb);
+
+        // 2-3. Envelope and reduction
+        for (int k = 0; k < nb; ++k)
+        {
+            const float c = lv[k] > env[k] ? att[k] : rel[k];
+            env[k] = lv[k] + c * (env[k] - lv[k]);
+            red[k] = juce::jmax (0.0f, env[k] - thr[k]) * sl[k];
+        }
+
+        // 4. Smoothing across bins: one gain per main lobe
+        sm[0] = juce::jmax (red[0], red[1]);
+        sm[nb - 1] = juce::jmax (red[nb - 2], red[nb - 1]);
+        for (int k = 1; k < nb - 1; ++k)
+            sm[k] = juce::jmax (red[k - 1], red[k], red[k + 1]);
+
+        // dB -> linear gain: 10^(-r / 20) = 2^(-r * log2(10) / 20)
+        juce::FloatVectorOperations::copyWithMultiply (gain.data(), sm, -0.16609640f, nb);
+        FastMath::exp2 (gain.data(), gain.data(), nb);
+
+        for (int i = 0; i < numBands; ++i)
+        {
+            const auto& range = bandBins[static_cast<size_t> (i)];
+            const float r = range.second >= range.first
+                              ? juce::FloatVectorOperations::findMaximum (sm + range.first, range.second - range.first + 1)
+                              : 0.0f;
+            bandReductionDB[static_cast<size_t> (bands[static_cast<size_t> (i)].index)].store (r);
+        }
+    }
+
+    //==============================================================================
+    struct CurvePoint
+    {
+        float centre, low, high;                    // octaves (log2 Hz)
+        float thresholdDB, slope, attackMs, releaseMs;
+    };
+
+    void updateCurve()
+    {
+        curveNeedsUpdate = false;
+        levelOffsetDB = 20.0f * std::log10 (juce::MathConstants<float>::pi / static_cast<float> (fftSize));
+
+        // Sorted by frequency: at most MaxBands, so insertion sort in place
+        std::array<CurvePoint, MaxBands> points;
+        std::array<int, MaxBands> sorted;
+        for (int i = 0; i < numBands; ++i)
+        {
+            const auto& p = bands[static_cast<size_t> (i)].params;
+            const float centre = std::log2 (p.frequency);
+
+            // Bandwidth in octaves for a given Q
+            const float halfWidth = juce::jmax (minBandwidthOctaves,
+                                                std::asinh (0.5f / juce::jmax (0.1f, p.q)) / std::log (2.0f));
+            const bool toBottom = p.type == BandParams::FilterType::LowShelf || p.type == BandParams::FilterType::LowCut;
+            const bool toTop    = p.type == BandParams::FilterType::HighShelf || p.type == BandParams::FilterType::HighCut;
+
+            points[static_cast<size_t> (i)] = { centre,
+                                                 toBottom ? -std::numeric_limits<float>::infinity() : centre - halfWidth,
+                                                 toTop    ?  std::numeric_limits<float>::infinity() : centre + halfWidth,
+                                                 p.threshold, 1.0f - 1.0f / juce::jmax (1.0f, p.ratio),
+                                                 p.attackMs, p.releaseMs };
+
+            int j = i;
+            for (; j > 0 && points[static_cast<size_t> (sorted[static_cast<size_t> (j - 1)])].centre > centre; --j)
+                sorted[static_cast<size_t> (j)] = sorted[static_cast<size_t> (j - 1)];
+            sorted[static_cast<size_t> (j)] = i;
+        }
+
+        const float* octave = active->binOctave.data();
+        const auto hopSeconds = static_cast<float> (hop / sampleRate);
+        auto timeToCoeff = [hopSeconds] (float ms) { return std::exp (-hopSeconds / (0.001f * juce::jmax (0.1f, ms))); };
+
+        int next = 0;   // first sorted point above the current bin
+        for (int k = 0; k < numBins; ++k)
+        {
+            const float x = octave[k];
+            while (next < numBands && points[static_cast<size_t> (sorted[static_cast<size_t> (next)])].centre <= x)
+                ++next;
+
+            const CurvePoint* below = next > 0 ? &points[static_cast<size_t> (sorted[static_cast<size_t> (next - 1)])] : nullptr;
+            const CurvePoint* above = next < numBands ? &points[static_cast<size_t> (sorted[static_cast<size_t> (next)])] : nullptr;
+
+            const CurvePoint* a = nullptr;
+            const CurvePoint* b = nullptr;
+            float t = 0.0f;
+
+            if (below != nullptr && above != nullptr && below->high >= above->low)
+            {
+                a = below;
+                b = above;
+                t = (x - below->centre) / juce::jmax (1.0e-6f, above->centre - below->centre);
+            }
+            else if (below != nullptr && x <= below->high)
+            {
+                a = b = below;
+            }
+            else if (above != nullptr && x >= above->low)
+            {
+                a = b = above;
+            }
+
+            const auto i = static_cast<size_t> (k);
+            if (a == nullptr)
+            {
+                threshold[i] = noCurveDB;
+                slope[i] = 0.0f;
+                attackCoeff[i] = releaseCoeff[i] = 0.0f;
+                continue;
+            }
+
+            threshold[i]    = a->thresholdDB + t * (b->thresholdDB - a->thresholdDB);
+            slope[i]        = a->slope + t * (b->slope - a->slope);
+            attackCoeff[i]  = timeToCoeff (a->attackMs + t * (b->attackMs - a->attackMs));
+            releaseCoeff[i] = timeToCoeff (a->releaseMs + t * (b->releaseMs - a->releaseMs));
+        }
+
+        // Bins reported as each band's gain reduction
+        for (int i = 0; i < numBands; ++i)
+        {
+            const auto& p = points[static_cast<size_t> (i)];
+            int lo = 0;
+            while (lo < numBins && octave[lo] < p.low)
+                ++lo;
+            int hi = numBins - 1;
+            while (hi >= 0 && octave[hi] > p.high)
+                --hi;
+            bandBins[static_cast<size_t> (i)] = { lo, hi };
+        }
+    }
+
+    //==============================================================================
+    double sampleRate = 44100.0;
+    int numChannels = 2;
+
+    std::array<Tables, maxOrder - minOrder + 1> tables;
+    const Tables* active = nullptr;
+    int order = minOrder;
+    int fftSize = 1 << minOrder;
+    int hop = fftSize / overlap;
+    int numBins = fftSize / 2 + 1;
+
+    std::array<Channel, maxChannels> channels;
+    int hopPosition = 0;
+
+    // Per-bin state and curve
+    std::vector<float> power, level, envelope, reduction, smoothed, gain;
+    std::vector<float> threshold, slope, attackCoeff, releaseCoeff;
+    float levelOffsetDB = 0.0f;
+
+    std::array<Band, MaxBands> bands;
+    std::array<std::pair<int, int>, MaxBands> bandBins;   // inclusive, empty if second < first
+    int numBands = 0;
+    bool curveNeedsUpdate = true;
+
+    std::array<std::atomic<float>, MaxBands> bandReductionDB {};
+};
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "FFTBackend.h"
 
 //==============================================================================
 // Lock-free FIFO for pushing audio samples from audio thread to GUI thread
@@ -67,64 +68,247 @@ private:
 };
 
 //==============================================================================
-// Single-channel FFT data producer
+// Single-channel FFT data producer.
+//
+// The audio thread only appends samples to a fixed-capacity ring of atomics,
+// sized for the largest FFT, so its work does not depend on the analysis
+// settings. FFT size, overlap and window are requested through atomics and
+// applied by the analysis side at the start of processFFT, which is the only
+// place the size-dependent buffers are (re)allocated.
 //==============================================================================
 class SpectrumAnalyzer
 {
 public:
-    static constexpr int fftOrder = 12;            // 4096-point FFT
-    static constexpr int fftSize  = 1 << fftOrder; // 4096
-    // Trigger a new FFT every hopSize samples for higher visual update rate.
-    // hopSize=512 at 44100 Hz => ~86 FFT updates/sec (vs. ~10 before)
-    static constexpr int hopSize  = 512;
+    static constexpr int minFFTOrder     = 10;   // 1024 points
+    static constexpr int maxFFTOrder     = 15;   // 32768 points
+    static constexpr int defaultFFTOrder = 12;   // 4096 points
+    static constexpr int maxFFTSize      = 1 << maxFFTOrder;
+
+    // Fraction of each frame shared with the previous one
+    enum class Overlap { half, threeQuarters, sevenEighths };
+
+    enum class Window { hann, blackmanHarris, flatTop, rectangular };
+
+    struct Config
+    {
+        int fftOrder    = defaultFFTOrder;
+        Overlap overlap = Overlap::sevenEighths;   // 4096 / 512: ~94 frames/s at 48 kHz
+        Window window   = Window::hann;
+
+        int getFFTSize() const noexcept { return 1 << fftOrder; }
+        int getNumBins() const noexcept { return getFFTSize() / 2; }
+        int getHopSize() const noexcept { return getFFTSize() >> (1 + static_cast<int> (overlap)); }
+
+        bool operator== (const Config& other) const noexcept
+        {
+            return fftOrder == other.fftOrder && overlap == other.overlap && window == other.window;
+        }
+
+        bool operator!= (const Config& other) const noexcept { return ! operator== (other); }
+    };
+
+    // Fractional-octave smoothing of the magnitude frames (bandwidth per output bin)
+    enum class Smoothing { off, third, sixth, twelfth, twentyFourth };
+
+    static float getOctaveFraction (Smoothing s) noexcept
+    {
+        switch (s)
+        {
+            case Smoothing::third:        return 1.0f / 3.0f;
+            case Smoothing::sixth:        return 1.0f / 6.0f;
+            case Smoothing::twelfth:      return 1.0f / 12.0f;
+            case Smoothing::twentyFourth: return 1.0f / 24.0f;
+            case Smoothing::off:          break;
+        }
+        return 0.0f;
+    }
 
     SpectrumAnalyzer()
-        : fft (fftOrder),
-          window (static_cast<size_t> (fftSize), juce::dsp::WindowingFunction<float>::hann)
     {
-        circularBuffer.fill (0.0f);
-        fftData.fill (0.0f);
-        renderBuffer.fill (0.0f);
+        for (auto& s : ring)
+            s.store (0.0f, std::memory_order_relaxed);
+
+        applyConfig (Config{});
     }
 
+    //==============================================================================
+    // Audio thread
+    //==============================================================================
     void pushSamples (const float* data, int numSamples)
     {
-        for (int i = 0; i < numSamples; ++i)
+        silentSamples = 0;
+        write (data, numSamples);
+    }
+
+    // Idle-path equivalent of pushing numSamples zeros. Once a window of the
+    // largest size holds silence, further calls cost nothing.
+    void pushSilence (int numSamples)
+    {
+        if (silentSamples >= maxFFTSize)
+            return;
+
+        silentSamples += numSamples;
+        write (nullptr, numSamples);
+    }
+
+    //==============================================================================
+    // Analysis side (AnalysisScheduler worker thread)
+    //==============================================================================
+    // Any thread; takes effect at the next processFFT
+    void setConfig (const Config& c)
+    {
+        requestedConfig.store (packConfig (c));
+    }
+
+    Config getConfig() const { return unpackConfig (requestedConfig.load()); }
+
+    // Any thread; the processor sets this in prepareToPlay
+    void setSampleRate (double newSampleRate) { sampleRate.store (newSampleRate); }
+    double getSampleRate() const              { return sampleRate.load(); }
+
+    // Audio time between the last frame and the one before: every sample that arrived
+    // in between, however many hops that spans (frames are analysed at the scheduler's
+    // rate, not per hop, and not at all while the editor is hidden). For time
+    // constants over successive frames.
+    double getLastFrameSeconds() const noexcept
+    {
+        return static_cast<double> (lastFrameAdvance) / juce::jmax (1.0, getSampleRate());
+    }
+
+    // Stream position (total samples written) of the last analysed frame; tells a
+    // caller of processFFTPair whether this analyzer's frame is the new one
+    juce::int64 getLastFrameEnd() const noexcept { return lastFrameEnd; }
+
+    // Linear bin magnitudes of the last frame (unscaled, after smoothing if that is on),
+    // before the dB conversion and clamping; getConfig().getNumBins() values. Analysis thread.
+    const float* getLastMagnitudes() const noexcept { return renderBuffer.data(); }
+
+    // Any thread; takes effect at the next processFFT
+    void setSmoothing (Smoothing s) { requestedSmoothing.store (static_cast<int> (s)); }
+    Smoothing getSmoothing() const  { return static_cast<Smoothing> (requestedSmoothing.load()); }
+
+    // Analyses the newest window if a hop of new samples has arrived. magnitudeDB is
+    // resized to the current bin count (and cleared when that changes), so its size
+    // always tells the caller the resolution. Returns true if a new frame was written.
+    bool processFFT (std::vector<float>& magnitudeDB, float minDB = -100.0f, float maxDB = 0.0f)
+    {
+        if (! beginFrame (magnitudeDB))
+            return false;
+
+        fft->performFrequencyOnlyForwardTransform (renderBuffer.data());
+        endFrame (magnitudeDB, minDB, maxDB);
+        return true;
+    }
+
+    // processFFT for two analyzers at once (pre- and post-EQ). Both inputs are real, so
+    // when both have a frame at the same size they share one complex FFT: a's window is
+    // the real part, b's the imaginary part, and the spectra are separated afterwards with
+    //   A[k] = (Z[k] + conj Z[N-k]) / 2,   B[k] = (Z[k] - conj Z[N-k]) / 2j
+    // Otherwise each runs its own transform. Returns true if either frame was written.
+    static bool processFFTPair (SpectrumAnalyzer& a, SpectrumAnalyzer& b,
+                                std::vector<float>& magnitudeDBA, std::vector<float>& magnitudeDBB,
+                                float minDB = -100.0f, float maxDB = 0.0f)
+    {
+        const bool hasA = a.beginFrame (magnitudeDBA);
+        const bool hasB = b.beginFrame (magnitudeDBB);
+
+        if (hasA && hasB && a.activeConfig.fftOrder == b.activeConfig.fftOrder)
         {
-            circularBuffer[static_cast<size_t> (writePos)] = data[i];
-            writePos = (writePos + 1) & (fftSize - 1);  // fftSize is power-of-2, bit-mask is safe
-            ++hopCounter;
-
-            if (hopCounter >= hopSize)
-            {
-                hopCounter = 0;
-                // writePos now points to the oldest slot → copy fftSize samples in order
-                for (int j = 0; j < fftSize; ++j)
-                    fftData[static_cast<size_t> (j)] =
-                        circularBuffer[static_cast<size_t> ((writePos + j) & (fftSize - 1))];
-                newFFTDataAvailable.set (true);
-            }
+            a.transformPair (b);
         }
+        else
+        {
+            if (hasA) a.fft->performFrequencyOnlyForwardTransform (a.renderBuffer.data());
+            if (hasB) b.fft->performFrequencyOnlyForwardTransform (b.renderBuffer.data());
+        }
+
+        if (hasA) a.endFrame (magnitudeDBA, minDB, maxDB);
+        if (hasB) b.endFrame (magnitudeDBB, minDB, maxDB);
+        return hasA || hasB;
     }
 
-    // Call from GUI thread to check if new data is available
-    bool isNewDataAvailable() const { return newFFTDataAvailable.get(); }
+private:
+    //==============================================================================
+    // Twice the largest window, so a reader copying the newest window is only
+    // lapped if the audio thread writes a further 32768 samples meanwhile.
+    // Writes are published in chunks of at most maxWriteSamples, which bounds how
+    // far the writer can be ahead of writeCount.
+    static constexpr int ringSize = 2 * maxFFTSize;
+    static constexpr int maxWriteSamples = 4096;
 
-    // Process FFT on GUI thread, fills magnitudeDB array
-    void processFFT (std::array<float, fftSize / 2>& magnitudeDB, float minDB = -100.0f, float maxDB = 0.0f)
+    void write (const float* data, int numSamples) noexcept
     {
-        if (! newFFTDataAvailable.compareAndSetBool (false, true))
-            return;
+        auto start = writeCount.load (std::memory_order_relaxed);
+
+        while (numSamples > 0)
+        {
+            const int num = juce::jmin (numSamples, maxWriteSamples);
+            for (int i = 0; i < num; ++i)
+                ring[static_cast<size_t> ((start + i) & (ringSize - 1))]
+                    .store (data != nullptr ? data[i] : 0.0f, std::memory_order_relaxed);
+
+            start += num;
+            writeCount.store (start, std::memory_order_release);
+
+            if (data != nullptr)
+                data += num;
+            numSamples -= num;
+        }
+    }
+
+    // Copies the newest numSamples samples in time order. Fails if fewer than a hop
+    // arrived since the last frame, or if the writer lapped the copy (retried next call).
+    // The lap check counts the chunk the writer may be storing but has not published.
+    bool readLatestWindow (float* dest, int numSamples) noexcept
+    {
+        const auto end = writeCount.load (std::memory_order_acquire);
+        if (end - lastFrameEnd < activeConfig.getHopSize())
+            return false;
 
-        // Copy fftData snapshot to renderBuffer so audio thread can immediately overwrite fftData
-        std::copy (fftData.begin(), fftData.end(), renderBuffer.begin());
+        const auto start = end - numSamples;   // may be negative before the ring first fills: those slots are zero
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = ring[static_cast<size_t> ((start + i) & (ringSize - 1))].load (std::memory_order_relaxed);
+
+        std::atomic_thread_fence (std::memory_order_acquire);
+        if (writeCount.load (std::memory_order_relaxed) + maxWriteSamples - ringSize > start)
+            return false;
+
+        lastFrameAdvance = end - lastFrameEnd;
+        lastFrameEnd = end;
+        return true;
+    }
+
+    // Applies a pending config, sizes magnitudeDB and leaves the windowed newest
+    // frame in renderBuffer. False if there is no new frame yet.
+    bool beginFrame (std::vector<float>& magnitudeDB)
+    {
+        const auto config = getConfig();
+        if (config != activeConfig)
+            applyConfig (config);
+
+        const int fftSize = activeConfig.getFFTSize();
+        const auto numBins = static_cast<size_t> (activeConfig.getNumBins());
+
+        if (magnitudeDB.size() != numBins)
+            magnitudeDB.assign (numBins, 0.0f);
+
+        if (! readLatestWindow (renderBuffer.data(), fftSize))
+            return false;
 
         window.multiplyWithWindowingTable (renderBuffer.data(), static_cast<size_t> (fftSize));
-        fft.performFrequencyOnlyForwardTransform (renderBuffer.data());
+        return true;
+    }
+
+    // Bin magnitudes in renderBuffer -> optional smoothing -> normalised dB
+    void endFrame (std::vector<float>& magnitudeDB, float minDB, float maxDB)
+    {
+        const int numBins = activeConfig.getNumBins();
+        const float scaleFactor = 1.0f / static_cast<float> (activeConfig.getFFTSize());
 
-        const float scaleFactor = 1.0f / static_cast<float> (fftSize);
+        if (getSmoothing() != Smoothing::off)
+            smoothPower (renderBuffer.data());
 
-        for (int i = 0; i < fftSize / 2; ++i)
+        for (int i = 0; i < numBins; ++i)
         {
             float magnitude = renderBuffer[static_cast<size_t> (i)] * scaleFactor;
             float db = juce::Decibels::gainToDecibels (magnitude, minDB);
@@ -132,16 +316,151 @@ public:
         }
     }
 
-private:
-    juce::dsp::FFT fft;
-    juce::dsp::WindowingFunction<float> window;
+    // One complex FFT of (this + j other), separated into the two bin magnitudes,
+    // which are written to the start of each renderBuffer as the real path does
+    void transformPair (SpectrumAnalyzer& other)
+    {
+        using Complex = std::complex<float>;
+        const int fftSize = activeConfig.getFFTSize();
+        const auto n = static_cast<size_t> (fftSize);
+
+        if (packedBuffer.size() != 2 * n)
+            packedBuffer.assign (2 * n, Complex{});
+
+        Complex* time = packedBuffer.data();
+        Complex* freq = packedBuffer.data() + n;
+
+        for (size_t i = 0; i < n; ++i)
+            time[i] = { renderBuffer[i], other.renderBuffer[i] };
+
+        fft->perform (time, freq);
+
+        for (size_t k = 0; k < n / 2; ++k)
+        {
+            const Complex z  = freq[k];
+            const Complex zc = std::conj (freq[(n - k) & (n - 1)]);
+            const Complex sum  = z + zc;
+            const Complex diff = z - zc;
+            renderBuffer[k]       = 0.5f * std::sqrt (sum.real() * sum.real() + sum.imag() * sum.imag());
+            other.renderBuffer[k] = 0.5f * std::sqrt (diff.real() * diff.real() + diff.imag() * diff.imag());
+        }
+    }
+
+    static juce::dsp::WindowingFunction<float>::WindowingMethod toWindowingMethod (Window w) noexcept
+    {
+        using Method = juce::dsp::WindowingFunction<float>;
+        switch (w)
+        {
+            case Window::blackmanHarris: return Method::blackmanHarris;
+            case Window::flatTop:        return Method::flatTop;
+            case Window::rectangular:    return Method::rectangular;
+            case Window::hann:           break;
+        }
+        return Method::hann;
+    }
+
+    // Config packed into one int so a request is never seen half-written
+    static int packConfig (const Config& c) noexcept
+    {
+        return juce::jlimit (minFFTOrder, maxFFTOrder, c.fftOrder)
+             | (static_cast<int> (c.overlap) << 4)
+             | (static_cast<int> (c.window) << 8);
+    }
+
+    static Config unpackConfig (int packed) noexcept
+    {
+        Config c;
+        c.fftOrder = packed & 0xf;
+        c.overlap  = static_cast<Overlap> ((packed >> 4) & 0xf);
+        c.window   = static_cast<Window> ((packed >> 8) & 0xf);
+        return c;
+    }
+
+    // Analysis side only: rebuild everything that depends on the FFT size or window
+    void applyConfig (const Config& config)
+    {
+        const bool sizeChanged = config.fftOrder != activeConfig.fftOrder || renderBuffer.empty();
+        const auto fftSize = static_cast<size_t> (config.getFFTSize());
+
+        if (sizeChanged)
+        {
+            fft = FFTBackend::create (config.fftOrder);
+            renderBuffer.assign (2 * fftSize, 0.0f);
+            powerPrefix.assign (fftSize / 2 + 1, 0.0);
+            smoothingWindows.assign (fftSize / 2, SmoothingWindow{});
+            tableSmoothing = Smoothing::off;
+        }
+
+        window.fillWindowingTables (fftSize, toWindowingMethod (config.window), true);
+        activeConfig = config;
+    }
+
+    //==============================================================================
+    // Replaces each magnitude with the RMS over a fractional-octave window centred
+    // on its bin. Windows come from a prefix sum over power, so every output bin
+    // costs O(1) whatever the bandwidth.
+    void smoothPower (float* magnitudes)
+    {
+        const auto smoothing = getSmoothing();
+        if (smoothing != tableSmoothing)
+            rebuildSmoothingTable (smoothing);
+
+        const int numBins = activeConfig.getNumBins();
+        powerPrefix[0] = 0.0;
+        for (int i = 0; i < numBins; ++i)
+        {
+            const double m = magnitudes[i];
+            powerPrefix[static_cast<size_t> (i + 1)] = powerPrefix[static_cast<size_t> (i)] + m * m;
+        }
+
+        for (int i = 0; i < numBins; ++i)
+        {
+            const auto& w = smoothingWindows[static_cast<size_t> (i)];
+            const double sum = powerPrefix[static_cast<size_t> (w.end)] - powerPrefix[static_cast<size_t> (w.begin)];
+            magnitudes[i] = static_cast<float> (std::sqrt (juce::jmax (0.0, sum) / static_cast<double> (w.end - w.begin)));
+        }
+    }
+
+    // Bin k averages bins [k * 2^(-f/2), k * 2^(f/2)] for an octave fraction f
+    void rebuildSmoothingTable (Smoothing smoothing)
+    {
+        tableSmoothing = smoothing;
+        const double halfWidth = std::exp2 (0.5 * static_cast<double> (getOctaveFraction (smoothing)));
+        const int numBins = activeConfig.getNumBins();
+
+        for (int k = 0; k < numBins; ++k)
+        {
+            auto& w = smoothingWindows[static_cast<size_t> (k)];
+            w.begin = juce::jlimit (0, k, static_cast<int> (std::floor (k / halfWidth + 0.5)));
+            w.end   = juce::jlimit (k + 1, numBins, static_cast<int> (std::floor (k * halfWidth + 0.5)) + 1);
+        }
+    }
+
+    struct SmoothingWindow { int begin = 0, end = 1; };   // bin range [begin, end)
+
+    // Shared with the audio thread
+    std::array<std::atomic<float>, ringSize> ring;
+    std::atomic<juce::int64> writeCount { 0 };   // total samples written
+    int silentSamples = 0;                       // audio thread: consecutive samples fed through pushSilence()
+
+    std::atomic<int> requestedConfig { packConfig (Config{}) };
+    std::atomic<int> requestedSmoothing { static_cast<int> (Smoothing::off) };
+    std::atomic<double> sampleRate { 44100.0 };
+
+    // Analysis side only; sized by applyConfig
+    Config activeConfig;
+    juce::int64 lastFrameEnd = 0;   // writeCount at the last analysed frame
+    juce::int64 lastFrameAdvance = 0;   // samples between the last two analysed frames
+    std::unique_ptr<FFTBackend> fft;
+    juce::dsp::WindowingFunction<float> window { static_cast<size_t> (1 << defaultFFTOrder),
+                                                 juce::dsp::WindowingFunction<float>::hann };
+    std::vector<float> renderBuffer;   // window + FFT work buffer, 2 * fftSize
+    std::vector<std::complex<float>> packedBuffer;   // processFFTPair: time + frequency halves, 2 * fftSize
 
-    // Ring buffer holding the last fftSize samples for overlap-based FFT
-    std::array<float, fftSize>     circularBuffer {};   // written by audio thread
-    std::array<float, fftSize * 2> fftData        {};   // captured snapshot (audio thread writes, shared)
-    std::array<float, fftSize * 2> renderBuffer   {};   // GUI-thread-only work copy for FFT/window
-    int writePos   = 0;   // next write slot in circularBuffer, always in [0, fftSize-1]
-    int hopCounter = 0;   // counts new samples since last FFT trigger
+    // Fractional-octave smoothing
+    Smoothing tableSmoothing = Smoothing::off;
+    std::vector<double> powerPrefix;
+    std::vector<SmoothingWindow> smoothingWindows;
 
-    juce::Atomic<bool> newFFTDataAvailable { false };
+    JUCE_DECLARE_NON_COPYABLE (SpectrumAnalyzer)
 };
@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+    SpectrumTraces.h
+    Peak-hold, long-term average and max-hold traces derived from analyzer frames
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FastMath.h"
+
+//==============================================================================
+// Folds successive analyzer frames (normalised 0..1 over dbRange, as produced by
+// SpectrumAnalyzer::processFFT) into three slower traces:
+//
+//   peak hold - each bin holds its peak for holdSeconds (or forever), then
+//               falls at peakFallPerSecond towards the live value
+//   average   - power average, either exponential with a time constant of
+//               windowSeconds, or linear: the time-weighted mean of every frame
+//               since the last reset, continuing as an exponential average of
+//               the same horizon once windowSeconds have been averaged
+//   max hold  - largest value per bin since the last reset
+//
+// A trace that is switched off follows the live frame.
+//
+// Frames may arrive irregularly and far apart (the analysis runs at the
+// editor's rate), so each one carries the audio time since the previous one
+// and every time constant is applied over that time, not per frame. Audio
+// that was never analysed (while the editor was hidden) is not counted: a
+// frame advances the traces by at most maxFrameSeconds, so the first frame
+// after a pause does not replace the average and the peak holds on its own.
+//
+// The average is held as power, so any window length costs one frame of
+// memory. Every per-bin loop is branch-free, with select instead of if and
+// FastMath for the power <-> dB conversions, so they vectorise.
+//
+// Settings are atomics, written from any thread; process() and the trace
+// getters belong to the analysis thread.
+//==============================================================================
+class SpectrumTraces
+{
+public:
+    enum class Averaging { exponential, linear };
+
+    static constexpr float infiniteHold = std::numeric_limits<float>::infinity();
+    static constexpr float peakFallPerSecond = 0.2f;   // normalised units: 20 dB/s over a 100 dB range
+    static constexpr float maxFrameSeconds = 0.5f;     // longest gap between frames that counts as audio time
+
+    //==============================================================================
+    // Any thread
+    void setPeakHold (bool enabled, float holdSeconds)
+    {
+        peakHoldSeconds.store (holdSeconds);
+        peakHoldEnabled.store (enabled);
+    }
+
+    void setAverage (bool enabled, Averaging mode, float windowSeconds)
+    {
+        averageWindowSeconds.store (juce::jmax (0.1f, windowSeconds));
+        averageMode.store (static_cast<int> (mode));
+        averageEnabled.store (enabled);
+    }
+
+    void setMaxHold (bool enabled)  { maxHoldEnabled.store (enabled); }
+
+    // Restarts all three traces at the next frame
+    void reset()                    { resetRequested.store (true); }
+
+    bool isPeakHoldEnabled() const noexcept     { return peakHoldEnabled.load(); }
+    float getPeakHoldSeconds() const noexcept   { return peakHoldSeconds.load(); }
+    bool isAverageEnabled() const noexcept      { return averageEnabled.load(); }
+    Averaging getAveraging() const noexcept     { return static_cast<Averaging> (averageMode.load()); }
+    float getAverageSeconds() const noexcept    { return averageWindowSeconds.load(); }
+    bool isMaxHoldEnabled() const noexcept      { return maxHoldEnabled.load(); }
+    bool isAnyEnabled() const noexcept          { return isPeakHoldEnabled() || isAverageEnabled() || isMaxHoldEnabled(); }
+
+    //==============================================================================
+    // Analysis thread: fold in one frame, frameSeconds of audio after the previous one
+    void process (const std::vector<float>& frame, float frameSeconds, float dbRange = 100.0f)
+    {
+        const int n = static_cast<int> (frame.size());
+        if (resetRequested.exchange (false) || n != numBins)
+            restart (frame);
+
+        const float* v = frame.data();
+        frameSeconds = juce::jmin (frameSeconds, maxFrameSeconds);
+
+        if (isPeakHoldEnabled())
+            processPeakHold (v, frameSeconds);
+        else
+            std::copy (frame.begin(), frame.end(), peak.begin());
+
+        if (isMaxHoldEnabled())
+            juce::FloatVectorOperations::max (maxHold.data(), maxHold.data(), v, n);
+        else
+            std::copy (frame.begin(), frame.end(), maxHold.begin());
+
+        if (isAverageEnabled())
+        {
+            processAverage (v, frameSeconds, dbRange);
+        }
+        else
+        {
+            std::copy (frame.begin(), frame.end(), average.begin());
+            framesAveraged = 0;
+        }
+    }
+
+    const std::vector<float>& getPeakHold() const noexcept { return peak; }
+    const std::vector<float>& getAverage() const noexcept  { return average; }
+    const std::vector<float>& getMaxHold() const noexcept  { return maxHold; }
+
+private:
+    //==============================================================================
+    void restart (const std::vector<float>& frame)
+    {
+        numBins = static_cast<int> (frame.size());
+        peak = frame;
+        maxHold = frame;
+        average = frame;
+        peakAge.assign (frame.size(), 0.0f);
+        averagePower.assign (frame.size(), 0.0f);
+        scratch.assign (frame.size(), 0.0f);
+        framesAveraged = 0;
+    }
+
+    void processPeakHold (const float* v, float dt)
+    {
+        const float hold = getPeakHoldSeconds();
+        const float fall = peakFallPerSecond * dt;
+        float* p = peak.data();
+        float* age = peakAge.data();
+
+        for (int i = 0; i < numBins; ++i)
+        {
+            const bool rise = v[i] >= p[i];
+            const float newAge = rise ? 0.0f : age[i] + dt;
+            const float fallen = juce::jmax (v[i], p[i] - fall);
+            p[i] = rise ? v[i] : (newAge > hold ? fallen : p[i]);
+            age[i] = newAge;
+        }
+    }
+
+    void processAverage (const float* v, float dt, float dbRange)
+    {
+        // Normalised value x -> power 2^(k x), up to a constant factor (as in SpectrumAxis)
+        const float k = dbRange * 0.33219281f;   // log2(10) / 10
+        const float window = getAverageSeconds();
+
+        juce::FloatVectorOperations::copyWithMultiply (scratch.data(), v, k, numBins);
+        FastMath::exp2 (scratch.data(), scratch.data(), numBins);
+
+        // Linear: each frame stands for the dt before it, so the weight is its share of the
+        // time averaged so far (capped at the window)
+        ++framesAveraged;
+        averagedSeconds = framesAveraged == 1 ? dt : averagedSeconds + dt;
+        float weight;
+        if (framesAveraged == 1)
+            weight = 1.0f;
+        else if (getAveraging() == Averaging::linear)
+            weight = juce::jmin (1.0f, dt / juce::jmin (averagedSeconds, window));
+        else
+            weight = 1.0f - std::exp (-dt / window);
+
+        float* acc = averagePower.data();
+        const float* power = scratch.data();
+        for (int i = 0; i < numBins; ++i)
+            acc[i] += weight * (power[i] - acc[i]);
+
+        FastMath::log2 (average.data(), acc, numBins);
+        juce::FloatVectorOperations::multiply (average.data(), 1.0f / k, numBins);
+    }
+
+    //==============================================================================
+    std::atomic<bool> peakHoldEnabled { false };
+    std::atomic<float> peakHoldSeconds { 2.0f };
+    std::atomic<bool> averageEnabled { false };
+    std::atomic<int> averageMode { static_cast<int> (Averaging::exponential) };
+    std::atomic<float> averageWindowSeconds { 10.0f };
+    std::atomic<bool> maxHoldEnabled { false };
+    std::atomic<bool> resetRequested { false };
+
+    // Analysis thread only
+    int numBins = -1;
+    int framesAveraged = 0;
+    float averagedSeconds = 0.0f;
+    std::vector<float> peak, peakAge, maxHold, average;
+    std::vector<float> averagePower, scratch;
+};
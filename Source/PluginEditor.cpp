@@ -448,15 +448,7 @@ DynamicEQAudioProcessorEditor::DynamicEQAudioProcessorEditor (DynamicEQAudioProc
     navScrollBar.setAutoHide (false);
     navScrollBar.setColour (juce::ScrollBar::thumbColourId, juce::Colour (0xFF5A9FD4));
 
-    // Create ALL bands upfront (parameters are pre-registered for all numBands)
-    // Visibility is controlled by activeBandCount + collapse state
-    for (int i = 0; i < DynamicEQAudioProcessor::numBands; ++i)
-    {
-        auto* strip = new BandControlStrip (p, i);
-        controlContainer.addChildComponent (strip);   // parented to container, not editor
-        bandStrips.add (strip);
-    }
-
+    // Band strips are created by updateBandVisibility for the active bands only
     // Nav bar: +/- band buttons
     addAndMakeVisible (addBandBtn);
     addAndMakeVisible (removeBandBtn);
@@ -490,15 +482,23 @@ DynamicEQAudioProcessorEditor::DynamicEQAudioProcessorEditor (DynamicEQAudioProc
         resized();
     };
 
+    // Nav bar: options menu (performance report export, per-band timing)
+    addAndMakeVisible (optionsBtn);
+    optionsBtn.setTooltip (juce::String::fromUTF8 ("\u9009\u9879"));
+    optionsBtn.onClick = [this]() { showOptionsMenu(); };
+
     updateBandVisibility();
 
     setSize (960, 660);
     setResizable (true, true);
     setResizeLimits (800, 480, 1920, 1080);
+
+    startTimerHz (4);
 }
 
 DynamicEQAudioProcessorEditor::~DynamicEQAudioProcessorEditor()
 {
+    stopTimer();
     navScrollBar.removeListener (this);
     setLookAndFeel (nullptr);
 }
@@ -506,11 +506,24 @@ DynamicEQAudioProcessorEditor::~DynamicEQAudioProcessorEditor()
 void DynamicEQAudioProcessorEditor::updateBandVisibility()
 {
     int active = audioProcessor.getActiveBandCount();
+    shownBandCount = active;
+
+    // One strip (and its parameter attachments) per active band: removed bands drop theirs
+    if (bandStrips.size() > active)
+        bandStrips.removeRange (active, bandStrips.size() - active);
+
+    while (bandStrips.size() < active)
+    {
+        auto* strip = new BandControlStrip (audioProcessor, bandStrips.size());
+        controlContainer.addChildComponent (strip);   // parented to container, not editor
+        bandStrips.add (strip);
+    }
+
     for (int i = 0; i < bandStrips.size(); ++i)
         bandStrips[i]->setVisible (i < active && !controlAreaCollapsed);
     addBandBtn.setEnabled    (active < DynamicEQAudioProcessor::numBands);
     removeBandBtn.setEnabled (active > 1);
-    repaint();   // ensure "频段 x/8" label re-draws in paint()
+    repaint();   // ensure "频段 x/32" label re-draws in paint()
 }
 
 void DynamicEQAudioProcessorEditor::scrollBarMoved (juce::ScrollBar* /*bar*/, double newRangeStart)
@@ -533,6 +546,99 @@ void DynamicEQAudioProcessorEditor::updateNavScrollBar()
     }
 }
 
+void DynamicEQAudioProcessorEditor::timerCallback()
+{
+    // The band count can also change from the spectrum view (match EQ)
+    if (audioProcessor.getActiveBandCount() != shownBandCount)
+    {
+        updateBandVisibility();
+        resized();
+    }
+
+    if (! cpuMeterBounds.isEmpty())
+        repaint (cpuMeterBounds);
+}
+
+void DynamicEQAudioProcessorEditor::showOptionsMenu()
+{
+    auto& monitor = audioProcessor.getPerformanceMonitor();
+
+    juce::PopupMenu menu;
+    menu.addItem (juce::String::fromUTF8 ("\u5bfc\u51fa\u6027\u80fd\u62a5\u544a..."),  // Export performance report...
+                  [this]() { exportPerformanceReport(); });
+    menu.addItem (juce::String::fromUTF8 ("\u9010\u9891\u6bb5\u8ba1\u65f6"),             // Per-band timing
+                  true, monitor.isPerBandTimingEnabled(),
+                  [&monitor]() { monitor.setPerBandTimingEnabled (! monitor.isPerBandTimingEnabled()); });
+    menu.addItem (juce::String::fromUTF8 ("\u91cd\u7f6e\u7edf\u8ba1"),                    // Reset statistics
+                  [this, &monitor]() { monitor.reset(); spectrumComponent.resetPaintStats(); });
+    menu.addSeparator();
+
+    // Processing mode: band filters, or per-bin dynamics (adds one FFT frame of latency)
+    juce::PopupMenu modeMenu;
+    const juce::String modeNames[] = { juce::String::fromUTF8 ("\u9891\u6bb5\u6ee4\u6ce2\u5668"),        // Band filters
+                                       juce::String::fromUTF8 ("\u9891\u8c31\u52a8\u6001 (FFT 2048)"),  // Spectral dynamics
+                                       juce::String::fromUTF8 ("\u9891\u8c31\u52a8\u6001 (FFT 4096)") };
+    const int currentMode = static_cast<int> (audioProcessor.getProcessingMode());
+    for (int mode = 0; mode < 3; ++mode)
+    {
+        modeMenu.addItem (modeNames[mode], true, mode == currentMode, [this, mode]()
+        {
+            if (auto* param = audioProcessor.getAPVTS().getParameter ("processingMode"))
+            {
+                param->beginChangeGesture();
+                param->setValueNotifyingHost (param->convertTo0to1 (static_cast<float> (mode)));
+                param->endChangeGesture();
+            }
+        });
+    }
+    menu.addSubMenu (juce::String::fromUTF8 ("\u5904\u7406\u6a21\u5f0f"), modeMenu);              // Processing mode
+
+    menu.showMenuAsync (juce::PopupMenu::Options().withTargetComponent (&optionsBtn));
+}
+
+void DynamicEQAudioProcessorEditor::exportPerformanceReport()
+{
+    fileChooser = std::make_unique<juce::FileChooser> (
+        juce::String::fromUTF8 ("\u5bfc\u51fa\u6027\u80fd\u62a5\u544a"),
+        juce::File::getSpecialLocation (juce::File::userDocumentsDirectory).getChildFile ("DynamicEQ_performance.txt"),
+        "*.txt");
+
+    auto flags = juce::FileBrowserComponent::saveMode
+               | juce::FileBrowserComponent::canSelectFiles
+               | juce::FileBrowserComponent::warnAboutOverwriting;
+
+    fileChooser->launchAsync (flags, [this] (const juce::FileChooser& chooser)
+    {
+        auto file = chooser.getResult();
+        if (file == juce::File())
+            return;
+
+        auto title = "DynamicEQ performance report - "
+                   + juce::Time::getCurrentTime().toString (true, true)
+                   + " @ " + juce::String (audioProcessor.getCurrentSampleRate(), 0) + " Hz";
+        auto report = audioProcessor.getPerformanceMonitor().createReport (title);
+
+        const auto& paint = spectrumComponent.getPaintStats();
+        report << juce::newLine
+               << "Spectrum paint:    " << juce::String (paint.meanMs, 3) << " ms mean, "
+               << juce::String (paint.maxMs, 3) << " ms max over "
+               << juce::String (paint.numFrames) << " frames" << juce::newLine
+               << "Static layers:     " << juce::String (paint.staticLayerMs, 3) << " ms per render, "
+               << juce::String (paint.staticLayerRenders) << " renders" << juce::newLine;
+
+        // Since this editor's previous report (or the scheduler's start); other editors
+        // share the scheduler and keep their own reference
+        const auto analysis = spectrumComponent.getAnalysisStats();
+        report << "Analysis workers:  " << juce::String (analysis.numWorkers) << " shared by "
+               << juce::String (analysis.numJobs) << " editors, "
+               << juce::String (analysis.getLoadSince (lastReportAnalysisStats) * 100.0, 1) << "% busy, "
+               << juce::String (analysis.getJobsPerSecondSince (lastReportAnalysisStats), 1) << " frames/s"
+               << juce::newLine;
+        lastReportAnalysisStats = analysis;
+        file.replaceWithText (report);
+    });
+}
+
 void DynamicEQAudioProcessorEditor::paint (juce::Graphics& g)
 {
     g.fillAll (juce::Colour (0xFF0F0F1E));
@@ -564,6 +670,20 @@ void DynamicEQAudioProcessorEditor::paint (juce::Graphics& g)
                                 + juce::String (DynamicEQAudioProcessor::numBands);
         g.drawText (infoText, nb.reduced (10.0f, 0.0f).toNearestInt(),
                     juce::Justification::centredLeft);
+
+        // CPU meter: smoothed load, mean / p99 ns per sample, blocks over the real-time deadline
+        if (! cpuMeterBounds.isEmpty())
+        {
+            auto stats = audioProcessor.getPerformanceMonitor().getSnapshot();
+            g.setColour (stats.numOverruns > 0 ? juce::Colour (0xFFFF6B6B) : juce::Colour (0xFF6677AA));
+            g.setFont (juce::FontOptions (11.0f));
+            juce::String cpuText = "CPU " + juce::String (stats.cpuLoad * 100.0f, 1) + "%  "
+                                 + juce::String (stats.meanNsPerSample, 1) + " / p99 "
+                                 + juce::String (stats.p99NsPerSample, 1) + " ns  "
+                                 + juce::String::fromUTF8 ("\u8d85\u9650 ")
+                                 + juce::String (static_cast<juce::int64> (stats.numOverruns));
+            g.drawText (cpuText, cpuMeterBounds, juce::Justification::centredRight);
+        }
     }
 }
 
@@ -609,13 +729,17 @@ void DynamicEQAudioProcessorEditor::resized()
     {
         auto btnArea = navBarBounds.reduced (4, 4);
 
-        // Right side: collapse ▼/▲ (28px), gap, + (26px), gap, - (26px)
+        // Right side: collapse ▼/▲ (28px), gap, + (26px), gap, - (26px), gap, options (26px), CPU meter
         collapseBtn.setBounds    (btnArea.removeFromRight (28));
         btnArea.removeFromRight  (4);
         addBandBtn.setBounds     (btnArea.removeFromRight (26));
         btnArea.removeFromRight  (4);
         removeBandBtn.setBounds  (btnArea.removeFromRight (26));
         btnArea.removeFromRight  (4);
+        optionsBtn.setBounds     (btnArea.removeFromRight (26));
+        btnArea.removeFromRight  (6);
+        cpuMeterBounds = btnArea.removeFromRight (cpuMeterW);
+        btnArea.removeFromRight  (6);
 
         // Left side: label occupies ~90px, scrollbar takes whatever remains
         auto labelArea  = btnArea.removeFromLeft (90);
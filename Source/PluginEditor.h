@@ -56,7 +56,8 @@ private:
 
 //==============================================================================
 class DynamicEQAudioProcessorEditor : public juce::AudioProcessorEditor,
-                                      private juce::ScrollBar::Listener
+                                      private juce::ScrollBar::Listener,
+                                      private juce::Timer
 {
 public:
     DynamicEQAudioProcessorEditor (DynamicEQAudioProcessor&);
@@ -71,6 +72,11 @@ private:
     void scrollBarMoved (juce::ScrollBar*, double newRangeStart) override;
     void updateNavScrollBar();   // sync scrollbar range/thumb with viewport state
 
+    // Timer override (refreshes the CPU meter in the nav bar, follows band count changes)
+    void timerCallback() override;
+    void showOptionsMenu();
+    void exportPerformanceReport();
+
     DynamicEQAudioProcessor& audioProcessor;
 
     SpectrumComponent spectrumComponent;
@@ -87,15 +93,22 @@ private:
     juce::TextButton removeBandBtn { "-" };
     juce::TextButton collapseBtn;           // ▼ / ▲
     juce::ScrollBar  navScrollBar  { false }; // horizontal scrollbar in nav bar
+    juce::TextButton optionsBtn    { "..." };   // diagnostics / export menu
+
+    std::unique_ptr<juce::FileChooser> fileChooser;   // kept alive while the async dialog is open
+    AnalysisScheduler::Stats lastReportAnalysisStats; // the report's analysis load is measured since this
 
     // Layout state
     bool controlAreaCollapsed = false;
+    int  shownBandCount = 0;                // active band count the strips were laid out for
     juce::Rectangle<int> navBarBounds;      // saved for paint()
+    juce::Rectangle<int> cpuMeterBounds;    // CPU meter text area inside the nav bar
 
     static constexpr int navBarH    = 28;
     static constexpr int controlH   = 290;
     static constexpr int stripMinW  = 220;   // minimum strip width (triggers scroll)
     static constexpr int stripMaxW  = 250;   // maximum strip width (prevents over-stretch)
+    static constexpr int cpuMeterW  = 230;   // nav bar CPU meter text width
 
     void updateBandVisibility();
 
@@ -24,72 +24,92 @@ juce::AudioProcessorValueTreeState::ParameterLayout
 {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
 
-    // Default frequencies for 8 bands
-    const float defaultFreqs[numBands] = { 60.0f, 200.0f, 500.0f, 1000.0f, 2000.0f, 5000.0f, 10000.0f, 16000.0f };
+    // Default frequencies of the original 8 bands. Later bands are spread over 40 Hz..16 kHz
+    // by golden-ratio steps, so bands added one at a time never land on top of each other.
+    const float legacyFreqs[legacyNumBands] = { 60.0f, 200.0f, 500.0f, 1000.0f, 2000.0f, 5000.0f, 10000.0f, 16000.0f };
+    auto defaultFrequency = [&legacyFreqs] (int band)
+    {
+        if (band < legacyNumBands)
+            return legacyFreqs[band];
+
+        const double t = std::fmod (static_cast<double> (band - legacyNumBands) * 0.6180339887, 1.0);
+        return static_cast<float> (juce::roundToInt (40.0 * std::pow (400.0, t)));
+    };
 
     for (int i = 0; i < numBands; ++i)
     {
         auto prefix = "band" + juce::String (i) + "_";
 
+        // Bands beyond the original layout were added in parameter version 2
+        const int version = i < legacyNumBands ? 1 : 2;
+
         layout.add (std::make_unique<juce::AudioParameterFloat> (
-            juce::ParameterID { prefix + "freq", 1 },
+            juce::ParameterID { prefix + "freq", version },
             "Band " + juce::String (i + 1) + " Freq",
             juce::NormalisableRange<float> (20.0f, 20000.0f, 0.1f, 0.25f),
-            defaultFreqs[i]));
+            defaultFrequency (i)));
 
         layout.add (std::make_unique<juce::AudioParameterFloat> (
-            juce::ParameterID { prefix + "gain", 1 },
+            juce::ParameterID { prefix + "gain", version },
             "Band " + juce::String (i + 1) + " Gain",
             juce::NormalisableRange<float> (-24.0f, 24.0f, 0.1f),
             0.0f));
 
         layout.add (std::make_unique<juce::AudioParameterFloat> (
-            juce::ParameterID { prefix + "q", 1 },
+            juce::ParameterID { prefix + "q", version },
             "Band " + juce::String (i + 1) + " Q",
             juce::NormalisableRange<float> (0.1f, 10.0f, 0.01f, 0.5f),
             1.0f));
 
         layout.add (std::make_unique<juce::AudioParameterFloat> (
-            juce::ParameterID { prefix + "threshold", 1 },
+            juce::ParameterID { prefix + "threshold", version },
             "Band " + juce::String (i + 1) + " Threshold",
             juce::NormalisableRange<float> (-60.0f, 0.0f, 0.1f),
             -20.0f));
 
         layout.add (std::make_unique<juce::AudioParameterFloat> (
-            juce::ParameterID { prefix + "ratio", 1 },
+            juce::ParameterID { prefix + "ratio", version },
             "Band " + juce::String (i + 1) + " Ratio",
             juce::NormalisableRange<float> (1.0f, 20.0f, 0.1f, 0.5f),
             4.0f));
 
         layout.add (std::make_unique<juce::AudioParameterFloat> (
-            juce::ParameterID { prefix + "attack", 1 },
+            juce::ParameterID { prefix + "attack", version },
             "Band " + juce::String (i + 1) + " Attack",
             juce::NormalisableRange<float> (0.1f, 200.0f, 0.1f, 0.4f),
             10.0f));
 
         layout.add (std::make_unique<juce::AudioParameterFloat> (
-            juce::ParameterID { prefix + "release", 1 },
+            juce::ParameterID { prefix + "release", version },
             "Band " + juce::String (i + 1) + " Release",
             juce::NormalisableRange<float> (1.0f, 1000.0f, 1.0f, 0.4f),
             100.0f));
 
         layout.add (std::make_unique<juce::AudioParameterBool> (
-            juce::ParameterID { prefix + "enabled", 1 },
+            juce::ParameterID { prefix + "enabled", version },
             "Band " + juce::String (i + 1) + " Enabled",
             true));
 
         layout.add (std::make_unique<juce::AudioParameterBool> (
-            juce::ParameterID { prefix + "dynamic", 1 },
+            juce::ParameterID { prefix + "dynamic", version },
             "Band " + juce::String (i + 1) + " Dynamic",
             true));
 
         layout.add (std::make_unique<juce::AudioParameterChoice> (
-            juce::ParameterID { prefix + "type", 1 },
+            juce::ParameterID { prefix + "type", version },
             "Band " + juce::String (i + 1) + " Type",
             juce::StringArray { "Low Shelf", "Peak", "High Shelf", "Low Cut", "High Cut", "Notch", "Band Pass" },
-            (i == 0) ? 0 : ((i == numBands - 1) ? 2 : 1)));
+            (i == 0) ? 0 : ((i == legacyNumBands - 1) ? 2 : 1)));
     }
 
+    // Changes the reported latency, so it is not exposed to automation
+    layout.add (std::make_unique<juce::AudioParameterChoice> (
+        juce::ParameterID { "processingMode", 2 },
+        "Processing Mode",
+        juce::StringArray { "Bands", "Spectral 2048", "Spectral 4096" },
+        0,
+        juce::AudioParameterChoiceAttributes().withAutomatable (false)));
+
     return layout;
 }
 
@@ -107,10 +127,32 @@ DynamicEQAudioProcessor::DynamicEQAudioProcessor()
        apvts (*this, nullptr, "Parameters", createParameterLayout())
 #endif
 {
+    for (int i = 0; i < numBands; ++i)
+    {
+        auto prefix = "band" + juce::String (i) + "_";
+        auto& ptrs  = bandParamPointers[static_cast<size_t> (i)];
+
+        ptrs.freq      = apvts.getRawParameterValue (prefix + "freq");
+        ptrs.gain      = apvts.getRawParameterValue (prefix + "gain");
+        ptrs.q         = apvts.getRawParameterValue (prefix + "q");
+        ptrs.threshold = apvts.getRawParameterValue (prefix + "threshold");
+        ptrs.ratio     = apvts.getRawParameterValue (prefix + "ratio");
+        ptrs.attack    = apvts.getRawParameterValue (prefix + "attack");
+        ptrs.release   = apvts.getRawParameterValue (prefix + "release");
+        ptrs.enabled   = apvts.getRawParameterValue (prefix + "enabled");
+        ptrs.dynamic   = apvts.getRawParameterValue (prefix + "dynamic");
+        ptrs.type      = apvts.getRawParameterValue (prefix + "type");
+    }
+
+    processingModeParam = apvts.getRawParameterValue ("processingMode");
+    apvts.addParameterListener ("processingMode", this);
+    allocateBands (activeBandCount.load());
 }
 
 DynamicEQAudioProcessor::~DynamicEQAudioProcessor()
 {
+    apvts.removeParameterListener ("processingMode", this);
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -148,7 +190,8 @@ bool DynamicEQAudioProcessor::isMidiEffect() const
 
 double DynamicEQAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // Ringing of the slowest-decaying active band filter, down to -120 dB
+    return lastSampleRate > 0.0 ? static_cast<double> (hostTailSamples.load()) / lastSampleRate : 0.0;
 }
 
 int DynamicEQAudioProcessor::getNumPrograms()
@@ -187,11 +230,32 @@ void DynamicEQAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBl
     spec.maximumBlockSize = static_cast<juce::uint32> (samplesPerBlock);
     spec.numChannels = static_cast<juce::uint32> (getTotalNumOutputChannels());
 
-    for (int i = 0; i < numBands; ++i)
+    const juce::ScopedLock sl (bandAllocationLock);
+    preparedSpec = spec;
+    isPrepared = true;
+
+    grHistory.prepare (sampleRate);
+    preSpectrum.setSampleRate (sampleRate);
+    postSpectrum.setSampleRate (sampleRate);
+
+    spectralDynamics.prepare (sampleRate, getTotalNumOutputChannels());
+    const int mode = readProcessingMode();
+    selectedProcessingMode.store (mode);
+    applyProcessingMode (mode);
+    setLatencySamples (getProcessingModeLatency (mode));
+
+    detectors.prepare (sampleRate);
+
+    numSpectralBands = 0;
+    for (int i = 0; i < numBands && bands[static_cast<size_t> (i)] != nullptr; ++i)
     {
-        bands[static_cast<size_t> (i)].prepare (spec);
+        bands[static_cast<size_t> (i)]->prepare (spec);
         updateBandParams (i);
     }
+
+    updateTailLengths();
+    silentSamples = 0;
+    idle = false;
 }
 
 void DynamicEQAudioProcessor::releaseResources()
@@ -219,25 +283,150 @@ bool DynamicEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts
 }
 #endif
 
-void DynamicEQAudioProcessor::updateBandParams (int bandIndex)
+// Creates bands 0..count - 1 that have never been active, prepared for the current spec.
+// Callers publish the new active count only afterwards.
+void DynamicEQAudioProcessor::allocateBands (int count)
+{
+    const juce::ScopedLock sl (bandAllocationLock);
+    grHistory.allocate (count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        auto& band = bands[static_cast<size_t> (i)];
+        if (band != nullptr)
+            continue;
+
+        auto newBand = std::make_unique<DynamicEQBand>();
+        if (isPrepared)
+            newBand->prepare (preparedSpec);
+        newBand->updateParams (readBandParams (i));
+        band = std::move (newBand);
+    }
+}
+
+BandParams DynamicEQAudioProcessor::readBandParams (int bandIndex) const
 {
-    auto prefix = "band" + juce::String (bandIndex) + "_";
+    const auto& ptrs = bandParamPointers[static_cast<size_t> (bandIndex)];
 
     BandParams p;
-    p.frequency  = apvts.getRawParameterValue (prefix + "freq")->load();
-    p.gain       = apvts.getRawParameterValue (prefix + "gain")->load();
-    p.q          = apvts.getRawParameterValue (prefix + "q")->load();
-    p.threshold  = apvts.getRawParameterValue (prefix + "threshold")->load();
-    p.ratio      = apvts.getRawParameterValue (prefix + "ratio")->load();
-    p.attackMs   = apvts.getRawParameterValue (prefix + "attack")->load();
-    p.releaseMs  = apvts.getRawParameterValue (prefix + "release")->load();
-    p.enabled    = apvts.getRawParameterValue (prefix + "enabled")->load() > 0.5f;
-    p.dynamicOn  = apvts.getRawParameterValue (prefix + "dynamic")->load() > 0.5f;
-
-    int typeIndex = static_cast<int> (apvts.getRawParameterValue (prefix + "type")->load());
+    p.frequency  = ptrs.freq->load();
+    p.gain       = ptrs.gain->load();
+    p.q          = ptrs.q->load();
+    p.threshold  = ptrs.threshold->load();
+    p.ratio      = ptrs.ratio->load();
+    p.attackMs   = ptrs.attack->load();
+    p.releaseMs  = ptrs.release->load();
+    p.enabled    = ptrs.enabled->load() > 0.5f;
+    p.dynamicOn  = ptrs.dynamic->load() > 0.5f;
+
+    int typeIndex = static_cast<int> (ptrs.type->load());
     p.type = static_cast<BandParams::FilterType> (typeIndex);
+    return p;
+}
+
+void DynamicEQAudioProcessor::updateBandParams (int bandIndex)
+{
+    auto p = readBandParams (bandIndex);
+
+    // Spectral mode: the band keeps its static shape and hands its dynamics to the STFT stage
+    if (activeProcessingMode.load() != 0)
+    {
+        if (p.enabled && p.dynamicOn && numSpectralBands < numBands)
+            spectralBands[static_cast<size_t> (numSpectralBands++)] = { bandIndex, p };
+        p.dynamicOn = false;
+    }
+
+    detectors.setBand (bandIndex, p.attackMs, p.releaseMs, p.threshold, p.ratio, p.enabled && p.dynamicOn);
+
+    // Smoothing and coefficient updates happen inside the band, only for changed fields
+    bands[static_cast<size_t> (bandIndex)]->updateParams (p);
+}
+
+void DynamicEQAudioProcessor::updateTailLengths()
+{
+    int filterTail = 0;
+    int idleTail   = 0;
+
+    for (int i = 0; i < activeBandCount.load(); ++i)
+    {
+        const auto& band = *bands[static_cast<size_t> (i)];
+        filterTail = juce::jmax (filterTail, band.getFilterTailSamples());
+        idleTail   = juce::jmax (idleTail,   band.getIdleTailSamples());
+    }
+
+    // The STFT stage follows the filters: its overlap-add spread adds to their ringing
+    if (activeProcessingMode.load() != 0)
+    {
+        const int spread = spectralDynamics.getTailSamples() - spectralDynamics.getLatencySamples();
+        filterTail += spread;
+        idleTail   += spectralDynamics.getTailSamples();
+    }
+
+    idleTailSamples = idleTail;
+    hostTailSamples.store (filterTail);
+}
+
+int DynamicEQAudioProcessor::readProcessingMode() const
+{
+    return juce::jlimit (0, 2, static_cast<int> (processingModeParam->load()));
+}
+
+int DynamicEQAudioProcessor::getProcessingModeLatency (int mode)
+{
+    return mode != 0 ? Spectral::getLatencySamples (Spectral::minOrder + mode - 1) : 0;
+}
+
+// Audio thread (or prepareToPlay): both FFT sizes are allocated, so this only
+// switches tables and restarts the STFT stream
+void DynamicEQAudioProcessor::applyProcessingMode (int mode)
+{
+    if (mode != 0)
+        spectralDynamics.setOrder (Spectral::minOrder + mode - 1);
+    spectralDynamics.reset();
+    activeProcessingMode.store (mode);
+}
+
+// Any thread, including the audio thread when a host restores state while playing
+void DynamicEQAudioProcessor::parameterChanged (const juce::String& parameterID, float newValue)
+{
+    juce::ignoreUnused (parameterID, newValue);
+    triggerAsyncUpdate();
+}
+
+// Message thread: reports the new mode's latency, then hands the mode to the audio thread
+void DynamicEQAudioProcessor::handleAsyncUpdate()
+{
+    const int mode = readProcessingMode();
+    if (mode == selectedProcessingMode.load())
+        return;
 
-    bands[static_cast<size_t> (bandIndex)].updateParams (p);
+    setLatencySamples (getProcessingModeLatency (mode));
+    selectedProcessingMode.store (mode);
+}
+
+// Input has been silent for longer than every band's tail: the output is silent too,
+// so skip the bands and analyzers entirely
+void DynamicEQAudioProcessor::processIdleBlock (juce::AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
+
+    if (! idle)
+    {
+        // Residual state is below -120 dB; drop it so processing resumes from exact zero
+        for (int i = 0; i < activeBandCount.load(); ++i)
+            bands[static_cast<size_t> (i)]->reset();
+        detectors.reset();
+        spectralDynamics.reset();
+        idle = true;
+    }
+
+    buffer.clear();
+
+    preSpectrum.pushSilence (numSamples);
+    postSpectrum.pushSilence (numSamples);
+
+    for (int i = 0; i < activeBandCount.load(); ++i)
+        grHistory.push (i, 0.0f, numSamples);
 }
 
 void DynamicEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
@@ -245,6 +434,7 @@ void DynamicEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
 {
     juce::ignoreUnused (midiMessages);
     juce::ScopedNoDenormals noDenormals;
+    Monitor::ScopedBlockTimer blockTimer (performanceMonitor, buffer.getNumSamples(), lastSampleRate);
 
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -252,6 +442,26 @@ void DynamicEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
+    const int selectedMode = selectedProcessingMode.load();
+    if (selectedMode != activeProcessingMode.load())
+        applyProcessingMode (selectedMode);
+
+    // Silence detection: count consecutive input samples below -120 dB. The same peak
+    // feeds the band detectors.
+    const float inputPeak = buffer.getMagnitude (0, buffer.getNumSamples());
+    if (inputPeak <= silenceThreshold)
+        silentSamples = juce::jmin (silentSamples + buffer.getNumSamples(), std::numeric_limits<int>::max() / 2);
+    else
+        silentSamples = 0;
+
+    if (silentSamples > idleTailSamples)
+    {
+        processIdleBlock (buffer);
+        return;
+    }
+
+    idle = false;
+
     // Push pre-EQ spectrum data (mono sum)
     {
         const int numSamples = buffer.getNumSamples();
@@ -267,12 +477,42 @@ void DynamicEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     }
 
     // Update and process each ACTIVE band only
-    for (int i = 0; i < activeBandCount.load(); ++i)
-    {
+    const bool timeBands = performanceMonitor.isPerBandTimingEnabled();
+    const bool spectral = activeProcessingMode.load() != 0;
+    const int numActiveBands = activeBandCount.load();
+    numSpectralBands = 0;
+
+    for (int i = 0; i < numActiveBands; ++i)
         updateBandParams (i);
-        bands[static_cast<size_t> (i)].process (buffer);
+
+    // All bands' envelopes and gain reductions in one pass
+    detectors.process (inputPeak, buffer.getNumSamples(), numActiveBands, bandReductions.data());
+    detectorLevelDB.store (detectors.getLongTermLevelDB());
+
+    for (int i = 0; i < numActiveBands; ++i)
+    {
+        const auto bandStart = timeBands ? Monitor::now() : juce::int64 (0);
+
+        bands[static_cast<size_t> (i)]->process (buffer, bandReductions[static_cast<size_t> (i)]);
+        if (! spectral)
+            grHistory.push (i, bands[static_cast<size_t> (i)]->getGainReductionDB(), buffer.getNumSamples());
+
+        if (timeBands)
+            performanceMonitor.recordBand (i, bandStart, buffer.getNumSamples());
     }
 
+    // Spectral mode: per-bin dynamics after the static band shapes
+    if (spectral)
+    {
+        spectralDynamics.setBands (spectralBands.data(), numSpectralBands);
+        spectralDynamics.process (buffer);
+
+        for (int i = 0; i < activeBandCount.load(); ++i)
+            grHistory.push (i, spectralDynamics.getBandReductionDB (i), buffer.getNumSamples());
+    }
+
+    updateTailLengths();
+
     // Push post-EQ spectrum data
     {
         const int numSamples = buffer.getNumSamples();
@@ -287,19 +527,50 @@ void DynamicEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     }
 }
 
+void DynamicEQAudioProcessor::setAnalyzerConfig (const SpectrumAnalyzer::Config& config)
+{
+    preSpectrum.setConfig (config);
+    postSpectrum.setConfig (config);
+}
+
 float DynamicEQAudioProcessor::getBandGainReduction (int bandIndex) const
 {
-    if (bandIndex >= 0 && bandIndex < numBands)
-        return bands[static_cast<size_t> (bandIndex)].getGainReductionDB();
+    if (bandIndex >= 0 && bandIndex < getActiveBandCount())
+        return activeProcessingMode.load() != 0 ? spectralDynamics.getBandReductionDB (bandIndex)
+                                                : bands[static_cast<size_t> (bandIndex)]->getGainReductionDB();
     return 0.0f;
 }
 
 void DynamicEQAudioProcessor::setActiveBandCount (int count)
 {
     count = juce::jlimit (1, numBands, count);
+    allocateBands (count);
     activeBandCount.store (count);
 }
 
+void DynamicEQAudioProcessor::setBandParameter (int bandIndex, const juce::String& name, float value)
+{
+    if (bandIndex < 0 || bandIndex >= numBands)
+        return;
+
+    if (auto* param = apvts.getParameter ("band" + juce::String (bandIndex) + "_" + name))
+    {
+        param->beginChangeGesture();
+        param->setValueNotifyingHost (param->convertTo0to1 (value));
+        param->endChangeGesture();
+    }
+}
+
+void DynamicEQAudioProcessor::setBandShape (int bandIndex, const BandParams& params)
+{
+    setBandParameter (bandIndex, "type",    static_cast<float> (params.type));
+    setBandParameter (bandIndex, "freq",    params.frequency);
+    setBandParameter (bandIndex, "gain",    params.gain);
+    setBandParameter (bandIndex, "q",       params.q);
+    setBandParameter (bandIndex, "enabled", params.enabled ? 1.0f : 0.0f);
+    setBandParameter (bandIndex, "dynamic", params.dynamicOn ? 1.0f : 0.0f);
+}
+
 //==============================================================================
 bool DynamicEQAudioProcessor::hasEditor() const
 {
@@ -317,6 +588,11 @@ void DynamicEQAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
     auto state = apvts.copyState();
     // Save active band count as a ValueTree property
     state.setProperty ("activeBandCount", activeBandCount.load(), nullptr);
+
+    const auto analyzer = getAnalyzerConfig();
+    state.setProperty ("analyzerFftOrder", analyzer.fftOrder, nullptr);
+    state.setProperty ("analyzerOverlap", static_cast<int> (analyzer.overlap), nullptr);
+    state.setProperty ("analyzerWindow", static_cast<int> (analyzer.window), nullptr);
     std::unique_ptr<juce::XmlElement> xml (state.createXml());
     copyXmlToBinary (*xml, destData);
 }
@@ -329,7 +605,18 @@ void DynamicEQAudioProcessor::setStateInformation (const void* data, int sizeInB
         auto tree = juce::ValueTree::fromXml (*xml);
         // Restore active band count
         if (tree.hasProperty ("activeBandCount"))
-            activeBandCount.store (juce::jlimit (1, numBands, static_cast<int> (tree.getProperty ("activeBandCount"))));
+            setActiveBandCount (static_cast<int> (tree.getProperty ("activeBandCount")));
+
+        // Restore analyzer resolution (older sessions keep the defaults)
+        SpectrumAnalyzer::Config analyzer;
+        analyzer.fftOrder = juce::jlimit (SpectrumAnalyzer::minFFTOrder, SpectrumAnalyzer::maxFFTOrder,
+                                          static_cast<int> (tree.getProperty ("analyzerFftOrder", analyzer.fftOrder)));
+        analyzer.overlap  = static_cast<SpectrumAnalyzer::Overlap> (juce::jlimit (0, 2,
+                                static_cast<int> (tree.getProperty ("analyzerOverlap", static_cast<int> (analyzer.overlap)))));
+        analyzer.window   = static_cast<SpectrumAnalyzer::Window> (juce::jlimit (0, 3,
+                                static_cast<int> (tree.getProperty ("analyzerWindow", static_cast<int> (analyzer.window)))));
+        setAnalyzerConfig (analyzer);
+
         apvts.replaceState (tree);
     }
 }
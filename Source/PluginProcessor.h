@@ -11,16 +11,26 @@
 #include <JuceHeader.h>
 #include "DSP/SpectrumAnalyzer.h"
 #include "DSP/DynamicEQBand.h"
+#include "DSP/DetectorBank.h"
+#include "DSP/PerformanceMonitor.h"
+#include "DSP/GainReductionHistory.h"
+#include "DSP/SpectralDynamics.h"
 
 //==============================================================================
-class DynamicEQAudioProcessor : public juce::AudioProcessor
+class DynamicEQAudioProcessor : public juce::AudioProcessor,
+                                private juce::AudioProcessorValueTreeState::Listener,
+                                private juce::AsyncUpdater
 {
 public:
     //==============================================================================
-    // numBands is the MAXIMUM number of bands (parameters are always registered for all)
-    static constexpr int numBands = 8;
-
-    // Active band count (runtime, 1..numBands)
+    // numBands is the MAXIMUM number of bands. Parameters are always registered for all of
+    // them, bands 0..legacyNumBands - 1 with the IDs and defaults of the 8-band layout, so
+    // existing sessions and automation stay valid.
+    static constexpr int numBands = 32;
+    static constexpr int legacyNumBands = 8;
+
+    // Active band count (runtime, 1..numBands). Band objects are created on first
+    // activation, so only bands that were used cost memory and processing.
     int  getActiveBandCount() const { return activeBandCount.load(); }
     void setActiveBandCount (int count);
 
@@ -67,9 +77,34 @@ public:
     SpectrumAnalyzer& getPreSpectrumAnalyzer()  { return preSpectrum; }
     SpectrumAnalyzer& getPostSpectrumAnalyzer() { return postSpectrum; }
 
+    // FFT size / overlap / window shared by both analyzers; saved with the session
+    void setAnalyzerConfig (const SpectrumAnalyzer::Config& config);
+    SpectrumAnalyzer::Config getAnalyzerConfig() const { return postSpectrum.getConfig(); }
+
+    // Message thread: writes a band parameter (plain value) as one gesture, so hosts
+    // record it as automation
+    void setBandParameter (int bandIndex, const juce::String& name, float value);
+
+    // setBandParameter for the type, frequency, gain, Q, enable and dynamic switches
+    void setBandShape (int bandIndex, const BandParams& params);
+
+    // Band filters only, or per-bin dynamics on an STFT of 2048 / 4096 points
+    // (the bands keep their static shape; their dynamics move to the spectral stage)
+    enum class ProcessingMode { bands, spectral2048, spectral4096 };
+    ProcessingMode getProcessingMode() const { return static_cast<ProcessingMode> (activeProcessingMode.load()); }
+
     float getBandGainReduction (int bandIndex) const;
+
+    // Long-term input level in the band detectors' domain (dB), for deriving thresholds
+    float getDetectorLevelDB() const { return detectorLevelDB.load(); }
     double getCurrentSampleRate() const { return lastSampleRate; }
 
+    using Monitor = PerformanceMonitor<numBands>;
+    Monitor& getPerformanceMonitor() { return performanceMonitor; }
+
+    using GRHistory = GainReductionHistory<numBands>;
+    const GRHistory& getGainReductionHistory() const { return grHistory; }
+
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
 private:
@@ -79,17 +114,76 @@ private:
     // Active band count (default 4, max = numBands)
     std::atomic<int> activeBandCount { 4 };
 
-    // DSP
-    std::array<DynamicEQBand, numBands> bands;
+    // DSP: bands 0..activeBandCount - 1 run. Objects are created by allocateBands() before
+    // a count that includes them is published, and kept until destruction.
+    std::array<std::unique_ptr<DynamicEQBand>, numBands> bands;
+    juce::CriticalSection bandAllocationLock;                // allocateBands vs prepareToPlay
+    juce::dsp::ProcessSpec preparedSpec {};                  // spec new bands are prepared with
+    bool isPrepared = false;
+
+    // Envelopes and gain computers of all bands, updated together once per block
+    // from the input peak (audio thread)
+    DetectorBank<numBands> detectors;
+    std::array<float, numBands> bandReductions {};
+    std::atomic<float> detectorLevelDB { -100.0f };          // detectors.getLongTermLevelDB() for the GUI
+
+    // The mode switch is decided on the message thread, which reports the new latency
+    // first; the audio thread then only moves to the selected mode, whose FFT size
+    // prepare() has already allocated
+    using Spectral = SpectralDynamics<numBands>;
+    Spectral spectralDynamics;
+    std::atomic<float>* processingModeParam = nullptr;
+    std::atomic<int> selectedProcessingMode { 0 };           // mode the host's latency is for
+    std::atomic<int> activeProcessingMode { 0 };             // mode the audio thread is running
+    std::array<Spectral::Band, numBands> spectralBands;      // dynamic bands collected per block
+    int numSpectralBands = 0;
 
     // Spectrum analysis
     SpectrumAnalyzer preSpectrum;
     SpectrumAnalyzer postSpectrum;
 
+    // Raw parameter pointers per band, looked up once (no string building per block)
+    struct BandParamPointers
+    {
+        std::atomic<float>* freq      = nullptr;
+        std::atomic<float>* gain      = nullptr;
+        std::atomic<float>* q         = nullptr;
+        std::atomic<float>* threshold = nullptr;
+        std::atomic<float>* ratio     = nullptr;
+        std::atomic<float>* attack    = nullptr;
+        std::atomic<float>* release   = nullptr;
+        std::atomic<float>* enabled   = nullptr;
+        std::atomic<float>* dynamic   = nullptr;
+        std::atomic<float>* type      = nullptr;
+    };
+    std::array<BandParamPointers, numBands> bandParamPointers;
+
+    // Per-band gain reduction frames for the GUI meters / trails
+    GRHistory grHistory;
+
+    // processBlock timing (written by the audio thread, read by the editor)
+    Monitor performanceMonitor;
+
     double lastSampleRate = 44100.0;
 
+    // Silence detection / idle mode
+    static constexpr float silenceThreshold = DynamicEQBand::silenceFloor;   // -120 dB
+    int  silentSamples = 0;                     // consecutive silent input samples (audio thread)
+    int  idleTailSamples = 0;                   // longest band filter + envelope tail (audio thread)
+    bool idle = false;                          // bands and analyzers are bypassed
+    std::atomic<int> hostTailSamples { 0 };     // longest band filter tail, reported to the host
+
     // Helper
+    void allocateBands (int count);
+    BandParams readBandParams (int bandIndex) const;
     void updateBandParams (int bandIndex);
+    void updateTailLengths();
+    int readProcessingMode() const;
+    static int getProcessingModeLatency (int mode);
+    void applyProcessingMode (int mode);
+    void parameterChanged (const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+    void processIdleBlock (juce::AudioBuffer<float>& buffer);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DynamicEQAudioProcessor)
 };
@@ -0,0 +1,222 @@
+/*
+  ==============================================================================
+
+    SpectrumAxis.h
+    Precomputed pixel <-> frequency / dB mapping for the spectrum view
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../DSP/FastMath.h"
+
+//==============================================================================
+// Log-frequency x axis and linear dB y axis of the spectrum view.
+//
+// Tables are rebuilt only when the size or sample rate changes, so per-frame
+// mapping is a table lookup or a multiply-add instead of std::log / std::pow:
+//   x -> frequency : one entry per pixel, linearly interpolated in between
+//   frequency -> x : affine in log2(f), evaluated with FastMath::log2
+//   column -> bins : FFT bin range (or interpolation point) behind each
+//                    display column, used to reduce a whole frame at once
+//==============================================================================
+class SpectrumAxis
+{
+public:
+    static constexpr float minFreqHz = 20.0f;
+    static constexpr float maxFreqHz = 20000.0f;
+    static constexpr float minDB = -24.0f;
+    static constexpr float maxDB = 24.0f;
+
+    static constexpr int defaultPixelsPerColumn = 2;   // spectrum trace resolution
+
+    // How the bins inside one display column are combined
+    enum class Reduction { Peak, PowerAverage };
+
+    explicit SpectrumAxis(int columnWidthInPixels = defaultPixelsPerColumn)
+        : pixelsPerColumn(juce::jmax(1, columnWidthInPixels))
+    {
+    }
+
+    // Exact mappings (used to build the tables and by the benchmark)
+    static float exactFreqToX(float freq, float width)
+    {
+        return width * (std::log(freq / minFreqHz) / std::log(maxFreqHz / minFreqHz));
+    }
+
+    static float exactXToFreq(float x, float width)
+    {
+        return minFreqHz * std::pow(maxFreqHz / minFreqHz, x / width);
+    }
+
+    //==============================================================================
+    // Returns true if the size changed and the tables were rebuilt
+    bool setSize(int newWidth, int newHeight)
+    {
+        if (newWidth == width && newHeight == height)
+            return false;
+
+        width = newWidth;
+        height = newHeight;
+
+        const float w = static_cast<float>(juce::jmax(1, width));
+        xPerLog2 = w / std::log2(maxFreqHz / minFreqHz);
+        log2Min = std::log2(minFreqHz);
+        yPerDB = static_cast<float>(juce::jmax(1, height)) / (maxDB - minDB);
+
+        freqAtPixel.resize(static_cast<size_t>(juce::jmax(1, width) + 1));
+        for (size_t x = 0; x < freqAtPixel.size(); ++x)
+            freqAtPixel[x] = exactXToFreq(static_cast<float>(x), w);
+
+        rebuildBinTable();
+        return true;
+    }
+
+    // Returns true if the bin table was rebuilt
+    bool setSampleRate(double newSampleRate, int newFFTSize)
+    {
+        if (newSampleRate == sampleRate && newFFTSize == fftSize)
+            return false;
+
+        sampleRate = newSampleRate;
+        fftSize = newFFTSize;
+        rebuildBinTable();
+        return true;
+    }
+
+    int getWidth() const noexcept  { return width; }
+    int getHeight() const noexcept { return height; }
+    int getPixelsPerColumn() const noexcept { return pixelsPerColumn; }
+
+    //==============================================================================
+    float xToFreq(float x) const noexcept
+    {
+        if (freqAtPixel.empty())
+            return minFreqHz;
+
+        const float clamped = juce::jlimit(0.0f, static_cast<float>(freqAtPixel.size() - 1), x);
+        const auto i0 = static_cast<size_t>(clamped);
+        const auto i1 = juce::jmin(i0 + 1, freqAtPixel.size() - 1);
+        const float frac = clamped - static_cast<float>(i0);
+        return freqAtPixel[i0] + frac * (freqAtPixel[i1] - freqAtPixel[i0]);
+    }
+
+    float freqToX(float freq) const noexcept
+    {
+        return xPerLog2 * (FastMath::log2(juce::jmax(1.0f, freq)) - log2Min);
+    }
+
+    float dbToY(float db) const noexcept { return (maxDB - db) * yPerDB; }
+    float yToDb(float y) const noexcept  { return maxDB - y / yPerDB; }
+
+    //==============================================================================
+    // Display columns sit at x = column * getPixelsPerColumn()
+    int getNumColumns() const noexcept { return static_cast<int>(columns.size()); }
+    float columnToX(int column) const noexcept { return static_cast<float>(column * pixelsPerColumn); }
+
+    // Reduce one frame of normalised (0..1 over dbRange) bin magnitudes to one value per column.
+    // Columns wider than a bin take the peak or the power average of every bin they cover;
+    // columns narrower than a bin interpolate between the two nearest bins.
+    void mapSpectrum(const float *bins, int numBins, float *dest, Reduction reduction, float dbRange = 100.0f)
+    {
+        if (numBins != fftSize / 2)
+        {
+            juce::FloatVectorOperations::clear(dest, getNumColumns());
+            return;
+        }
+
+        // Power average: normalised value n -> 2^(k n) is power up to a constant factor
+        const float k = dbRange * 0.33219281f;   // log2(10) / 10
+        if (reduction == Reduction::PowerAverage)
+        {
+            powerScratch.resize(static_cast<size_t>(numBins));
+            juce::FloatVectorOperations::copyWithMultiply(powerScratch.data(), bins, k, numBins);
+            FastMath::exp2(powerScratch.data(), powerScratch.data(), numBins);
+        }
+
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            const auto &col = columns[c];
+
+            if (col.numBins == 0)
+            {
+                dest[c] = bins[col.firstBin] + col.frac * (bins[col.firstBin + 1] - bins[col.firstBin]);
+            }
+            else if (reduction == Reduction::Peak)
+            {
+                dest[c] = juce::FloatVectorOperations::findMaximum(bins + col.firstBin, col.numBins);
+            }
+            else
+            {
+                const float *power = powerScratch.data() + col.firstBin;
+                float sum = 0.0f;
+                for (int i = 0; i < col.numBins; ++i)
+                    sum += power[i];
+
+                dest[c] = FastMath::log2(sum / static_cast<float>(col.numBins)) / k;
+            }
+        }
+    }
+
+private:
+    // Either a bin range [firstBin, firstBin + numBins) or, with numBins == 0,
+    // an interpolation point between firstBin and firstBin + 1
+    struct Column
+    {
+        int firstBin = 0;
+        int numBins = 0;
+        float frac = 0.0f;
+    };
+
+    void rebuildBinTable()
+    {
+        columns.clear();
+        if (sampleRate <= 0.0 || fftSize <= 0 || width <= 0)
+            return;
+
+        const double binsPerHz = fftSize / sampleRate;
+        const int numBins = fftSize / 2;
+        const double halfColumn = 0.5 * pixelsPerColumn;
+        const double w = static_cast<double>(width);
+        const double ratio = static_cast<double>(maxFreqHz) / static_cast<double>(minFreqHz);
+        auto binAt = [&](double x) { return minFreqHz * std::pow(ratio, x / w) * binsPerHz; };
+
+        columns.resize(static_cast<size_t>((width + pixelsPerColumn - 1) / pixelsPerColumn));
+
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            const double x = static_cast<double>(c) * pixelsPerColumn;
+            const double lo = binAt(x - halfColumn);
+            const double hi = binAt(x + halfColumn);
+            auto &col = columns[c];
+
+            if (hi - lo < 1.0)
+            {
+                // Column narrower than a bin: interpolate at its centre frequency
+                const double centre = juce::jlimit(0.0, static_cast<double>(numBins - 1) - 1.0e-3, binAt(x));
+                col.firstBin = static_cast<int>(centre);
+                col.numBins = 0;
+                col.frac = static_cast<float>(centre - col.firstBin);
+            }
+            else
+            {
+                const int first = juce::jlimit(0, numBins - 1, juce::roundToInt(lo));
+                const int last = juce::jlimit(first + 1, numBins, juce::roundToInt(hi));
+                col.firstBin = first;
+                col.numBins = last - first;
+            }
+        }
+    }
+
+    int pixelsPerColumn;
+    int width = -1, height = -1;
+    double sampleRate = 0.0;
+    int fftSize = 0;
+
+    float xPerLog2 = 1.0f, log2Min = 0.0f, yPerDB = 1.0f;
+    std::vector<float> freqAtPixel;
+    std::vector<Column> columns;
+    std::vector<float> powerScratch;
+};
@@ -11,30 +11,9 @@
 
 #include <JuceHeader.h>
 #include "../PluginProcessor.h"
-
-//==============================================================================
-// Helper: map frequency (Hz) to x position in a given width (log scale)
-//==============================================================================
-inline float freqToX(float freq, float width, float minFreq = 20.0f, float maxFreq = 20000.0f)
-{
-    return width * (std::log(freq / minFreq) / std::log(maxFreq / minFreq));
-}
-
-inline float xToFreq(float x, float width, float minFreq = 20.0f, float maxFreq = 20000.0f)
-{
-    return minFreq * std::pow(maxFreq / minFreq, x / width);
-}
-
-// Map dB to y position within component height
-inline float dbToY(float db, float height, float minDB = -24.0f, float maxDB = 24.0f)
-{
-    return juce::jmap(db, maxDB, minDB, 0.0f, height);
-}
-
-inline float yToDb(float y, float height, float minDB = -24.0f, float maxDB = 24.0f)
-{
-    return juce::jmap(y, 0.0f, height, maxDB, minDB);
-}
+#include "../DSP/AnalysisScheduler.h"
+#include "../DSP/BiquadResponse.h"
+#include "SpectrumAxis.h"
 
 //==============================================================================
 // Band colors
@@ -51,70 +30,118 @@ inline juce::Colour getBandColour(int bandIndex)
 }
 
 //==============================================================================
-class SpectrumComponent : public juce::Component,
-                          public juce::Timer
+class SpectrumComponent : public juce::Component
 {
 public:
     SpectrumComponent(DynamicEQAudioProcessor &p)
         : processor(p)
     {
         setOpaque(true);
-        startTimerHz(60); // 60 fps refresh
-
-        smoothedPreSpectrum.fill(0.0f);
-        smoothedPostSpectrum.fill(0.0f);
-    }
 
-    ~SpectrumComponent() override
-    {
-        stopTimer();
+        const auto numBins = static_cast<size_t>(processor.getAnalyzerConfig().getNumBins());
+        preSpectrumData.assign(numBins, 0.0f);
+        postSpectrumData.assign(numBins, 0.0f);
+        resizeSpectra();
     }
 
     //==============================================================================
     void paint(juce::Graphics &g) override
     {
+        const auto paintStart = juce::Time::getHighResolutionTicks();
         auto bounds = getLocalBounds().toFloat();
 
-        // Dark background
-        g.fillAll(juce::Colour(0xFF1A1A2E));
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        if (showWaterfall)
+        {
+            // Post-EQ history fills the view; the grid and labels go on top
+            if (!waterfall.isValid() || scale != waterfallScale)
+                createWaterfall(scale);
+            drawWaterfall(g);
+            drawGrid(g, bounds);
+            g.setColour(juce::Colour(0xFF333355));
+            g.drawRect(bounds, 1.0f);
+        }
+        else
+        {
+            // Background, grid, labels and border come from a cached image
+            if (!staticLayer.isValid() || scale != staticLayerScale)
+                renderStaticLayer(scale);
+            g.drawImage(staticLayer, bounds);
 
-        // Draw grid
-        drawGrid(g, bounds);
+            // Draw pre-EQ spectrum (dimmer)
+            drawSpectrum(g, bounds, smoothedPreSpectrum, juce::Colour(0x30FFFFFF), juce::Colour(0x08FFFFFF));
+
+            // Draw post-EQ spectrum (brighter)
+            drawSpectrum(g, bounds, smoothedPostSpectrum, juce::Colour(0x6000D4FF), juce::Colour(0x1800D4FF));
 
-        // Draw pre-EQ spectrum (dimmer)
-        drawSpectrum(g, bounds, smoothedPreSpectrum, juce::Colour(0x30FFFFFF), juce::Colour(0x08FFFFFF));
+            // Long-term post-EQ traces, lines only
+            drawTraces(g, bounds);
+        }
 
-        // Draw post-EQ spectrum (brighter)
-        drawSpectrum(g, bounds, smoothedPostSpectrum, juce::Colour(0x6000D4FF), juce::Colour(0x1800D4FF));
+        if (analysisJob.isResonanceDetectionEnabled())
+            drawResonances(g, bounds);
 
         // Draw EQ curves from cached data
         drawCachedEQCurve(g, bounds);
 
         // Draw individual band curves (subtle)
-        int activeBands = processor.getActiveBandCount();
+        int activeBands = syncBandStorage();
         for (int i = 0; i < activeBands; ++i)
             drawCachedBandCurve(g, bounds, i);
 
         // Draw draggable nodes on top
         for (int i = 0; i < activeBands; ++i)
-            drawNode(g, bounds, i);
+            drawNode(g, i);
 
-        // Draw border
-        g.setColour(juce::Colour(0xFF333355));
-        g.drawRect(bounds, 1.0f);
+        if (showFrameStats)
+            drawFrameStats(g);
+
+        recordPaintTime(juce::Time::getHighResolutionTicks() - paintStart);
     }
 
     void resized() override
     {
+        axis.setSize(getWidth(), getHeight());
         curveNeedsUpdate = true;
+        staticLayer = {};
+        waterfall = {};
     }
 
+    // Time spent in paint(), for the exported performance report
+    struct PaintStats
+    {
+        juce::int64 numFrames = 0;
+        double meanMs = 0.0;    // smoothed over roughly the last second
+        double maxMs = 0.0;
+        int staticLayerRenders = 0;   // cached grid/label image rebuilds
+        double staticLayerMs = 0.0;   // cost of the last rebuild (previously paid every frame)
+    };
+    const PaintStats &getPaintStats() const noexcept { return paintStats; }
+    void resetPaintStats() noexcept
+    {
+        paintStats.numFrames = 0;
+        paintStats.meanMs = 0.0;
+        paintStats.maxMs = 0.0;
+    }
+
+    // Shared analysis pool, cumulative: take deltas against an earlier snapshot
+    AnalysisScheduler::Stats getAnalysisStats() const { return analysisJob.getSchedulerStats(); }
+
     //==============================================================================
     void mouseDown(const juce::MouseEvent &e) override
     {
+        if (e.mods.isPopupMenu())
+        {
+            showAnalyzerMenu();
+            return;
+        }
+
         dragBandIndex = hitTestNode(e.position);
         if (dragBandIndex >= 0)
+        {
             beginDrag(dragBandIndex, e.position);
+            repaintNode(dragBandIndex);
+        }
     }
 
     void mouseDrag(const juce::MouseEvent &e) override
@@ -125,6 +152,7 @@ public:
 
     void mouseUp(const juce::MouseEvent & /*e*/) override
     {
+        repaintNode(dragBandIndex);
         dragBandIndex = -1;
     }
 
@@ -133,14 +161,12 @@ public:
         int hit = hitTestNode(e.position);
         setMouseCursor(hit >= 0 ? juce::MouseCursor::DraggingHandCursor
                                 : juce::MouseCursor::NormalCursor);
-        hoveredBand = hit;
-        repaint();
+        setHoveredBand(hit);
     }
 
     void mouseExit(const juce::MouseEvent & /*e*/) override
     {
-        hoveredBand = -1;
-        repaint();
+        setHoveredBand(-1);
     }
 
     // Scroll to adjust Q
@@ -164,17 +190,44 @@ private:
     DynamicEQAudioProcessor &processor;
 
     // Spectrum data
-    std::array<float, SpectrumAnalyzer::fftSize / 2> preSpectrumData{};
-    std::array<float, SpectrumAnalyzer::fftSize / 2> postSpectrumData{};
-    std::array<float, SpectrumAnalyzer::fftSize / 2> smoothedPreSpectrum{};
-    std::array<float, SpectrumAnalyzer::fftSize / 2> smoothedPostSpectrum{};
-
-    // Cached EQ curve data (per-band magnitudes in dB, sampled at curveNumPoints)
+    // Sized by the analyzers to their current bin count
+    std::vector<float> preSpectrumData;
+    std::vector<float> postSpectrumData;
+    std::vector<float> smoothedPreSpectrum;
+    std::vector<float> smoothedPostSpectrum;
+
+    // Match EQ: long-term input spectra, captured by analysisJob (so declared before it,
+    // to outlive it) and fitted on a background thread
+    SpectrumCapture referenceCapture;
+    SpectrumCapture sourceCapture;
+    MatchSpectrum fileReference;          // replaces referenceCapture when valid
+    bool matchBusy = false;               // file analysis or fit in flight
+    juce::String matchStatus;
+    std::unique_ptr<juce::FileChooser> referenceChooser;
+    static constexpr int matchFitBands = 8;   // a broad tonal match; more bands only chase noise
+
+    // FFTs run on the shared analysis workers; advanceFrame pulls the newest frame
+    SpectrumAnalysisJob analysisJob{processor.getPreSpectrumAnalyzer(), processor.getPostSpectrumAnalyzer()};
+
+    // Post-EQ peak-hold / long-term average / max-hold, computed by analysisJob
+    std::vector<float> peakHoldTrace;
+    std::vector<float> averageTrace;
+    std::vector<float> maxHoldTrace;
+
+    // Resonances found in the post-EQ spectrum by analysisJob, strongest first
+    std::vector<ResonanceDetector::Suggestion> resonanceSuggestions;
+
+    // Cached EQ curve data in dB, sampled at curveNumPoints. Only dirty bands are re-evaluated;
+    // the total is the sum of the per-band dB curves (product of the linear responses).
     static constexpr int curveNumPoints = 1024;
-    std::array<std::array<float, curveNumPoints>, DynamicEQAudioProcessor::numBands> cachedBandMagnitudes{};
+    std::vector<std::array<float, curveNumPoints>> cachedBandMagnitudes;   // per active band
     std::array<float, curveNumPoints> cachedTotalMagnitude{};
     std::array<double, curveNumPoints> curveFrequencies{};
-    bool curveNeedsUpdate = true;
+    BiquadResponse curveResponse;
+    std::vector<bool> bandCurveDirty;
+    double curveSampleRate = 0.0;
+    bool curveNeedsUpdate = true;   // sampling grid (width / sample rate) is stale
+    bool totalCurveDirty = true;
 
     // Track parameter changes for efficient curve update
     struct BandSnapshot
@@ -183,7 +236,34 @@ private:
         int type = 0;
         bool enabled = false, dynamic = false;
     };
-    std::array<BandSnapshot, DynamicEQAudioProcessor::numBands> lastSnapshots{};
+    std::vector<BandSnapshot> lastSnapshots;
+
+    // Gain-reduction meters / trails fed from the processor's history ring (1 kHz frames)
+    using GRHistory = DynamicEQAudioProcessor::GRHistory;
+    static constexpr int grFramesPerColumn = 4;     // 4 ms per trail column
+    static constexpr int grTrailColumns    = 250;   // ~1 s of trail
+    static constexpr float grTrailWidth    = 80.0f; // px drawn to the left of the node
+    static constexpr float grMeterFallDB   = 0.3f;  // meter peak fall per 1/60 s
+
+    struct GRTrail
+    {
+        std::array<float, grTrailColumns> columns{}; // max GR per column (ring)
+        int head = 0;                                // next column to write
+        int numVisibleColumns = 0;                   // columns above the draw threshold
+        float columnMax = 0.0f;
+        int columnFrames = 0;
+        juce::int64 nextFrame = -1;                  // next history frame to read
+        float meterPeak = 0.0f;                      // peak GR with fall-off
+    };
+    std::vector<GRTrail> grTrails;
+    std::array<GRHistory::Frame, GRHistory::capacity> grReadBuffer{};
+    static constexpr float grVisibleDB = 0.1f;      // smallest GR drawn as trail / meter
+
+    // Spectra as of the last repaint: a frame is skipped while neither trace moved by more
+    // than repaintThresholdPx and no curve, node or trail changed
+    std::vector<float> paintedPreSpectrum;
+    std::vector<float> paintedPostSpectrum;
+    static constexpr float repaintThresholdPx = 0.5f;
 
     int dragBandIndex = -1;
     int hoveredBand = -1;
@@ -197,55 +277,834 @@ private:
 
     static constexpr float nodeRadius = 10.0f;
     static constexpr float glowRadius = 22.0f;
-    static constexpr float minFreqHz = 20.0f;
-    static constexpr float maxFreqHz = 20000.0f;
-    static constexpr float minDB = -24.0f;
-    static constexpr float maxDB = 24.0f;
+    static constexpr float minFreqHz = SpectrumAxis::minFreqHz;
+    static constexpr float maxFreqHz = SpectrumAxis::maxFreqHz;
+    static constexpr float minDB = SpectrumAxis::minDB;
+    static constexpr float maxDB = SpectrumAxis::maxDB;
+
+    SpectrumAxis axis;       // pixel <-> frequency / dB tables, rebuilt on resize
+    SpectrumAxis::Reduction spectrumReduction = SpectrumAxis::Reduction::Peak;
+    std::vector<float> columnValues;   // drawSpectrum scratch, one value per display column
+    PaintStats paintStats;
+
+    // Static layers, rendered at the display's physical resolution; invalidated on resize or
+    // scale-factor change
+    juce::Image staticLayer;
+    float staticLayerScale = 0.0f;
+
+    void renderStaticLayer(float scale)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        staticLayerScale = scale;
+        staticLayer = juce::Image(juce::Image::RGB,
+                                  juce::jmax(1, juce::roundToInt(static_cast<float>(getWidth()) * scale)),
+                                  juce::jmax(1, juce::roundToInt(static_cast<float>(getHeight()) * scale)),
+                                  false);
+
+        juce::Graphics g(staticLayer);
+        g.addTransform(juce::AffineTransform::scale(scale));
+        auto bounds = getLocalBounds().toFloat();
+
+        // Dark background
+        g.fillAll(juce::Colour(0xFF1A1A2E));
+
+        // Draw grid
+        drawGrid(g, bounds);
+
+        // Draw border
+        g.setColour(juce::Colour(0xFF333355));
+        g.drawRect(bounds, 1.0f);
+
+        ++paintStats.staticLayerRenders;
+        paintStats.staticLayerMs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1000.0;
+    }
+
+    //==============================================================================
+    // Waterfall: one row per analysis frame, newest at the top. Rows are written into
+    // a ring-buffered software image in place; painting draws the ring as two blits,
+    // so the history is never re-rendered.
+    bool showWaterfall = false;
+    juce::Image waterfall;
+    float waterfallScale = 0.0f;
+    int waterfallRow = 0;                  // ring position of the newest row
+    SpectrumAxis waterfallAxis{1};         // per-pixel columns at the image's physical width
+    std::vector<float> waterfallValues;
+    std::array<juce::PixelARGB, 256> waterfallColours = makeWaterfallColours();
+
+    static inline const juce::Colour waterfallBackground{0xFF1A1A2E};   // silence = view background
+
+    static std::array<juce::PixelARGB, 256> makeWaterfallColours()
+    {
+        juce::ColourGradient gradient(waterfallBackground, 0.0f, 0.0f, juce::Colours::white, 1.0f, 0.0f, false);
+        gradient.addColour(0.35, juce::Colour(0xFF1B2A80));
+        gradient.addColour(0.60, juce::Colour(0xFF00D4FF));
+        gradient.addColour(0.85, juce::Colour(0xFFFFD93D));
+
+        std::array<juce::PixelARGB, 256> lut;
+        for (size_t i = 0; i < lut.size(); ++i)
+            lut[i] = gradient.getColourAtPosition(static_cast<double>(i) / 255.0).getPixelARGB();
+        return lut;
+    }
+
+    void createWaterfall(float scale)
+    {
+        waterfallScale = scale;
+        const int w = juce::jmax(1, juce::roundToInt(static_cast<float>(getWidth()) * scale));
+        const int h = juce::jmax(1, juce::roundToInt(static_cast<float>(getHeight()) * scale));
+
+        waterfall = juce::Image(juce::Image::RGB, w, h, false, juce::SoftwareImageType());
+        waterfall.clear(waterfall.getBounds(), waterfallBackground);
+        waterfallRow = 0;
+
+        waterfallAxis.setSize(w, h);
+        waterfallAxis.setSampleRate(processor.getCurrentSampleRate(), static_cast<int>(postSpectrumData.size()) * 2);
+    }
+
+    // Returns true if a row was written
+    bool pushWaterfallRow()
+    {
+        if (!waterfall.isValid() || postSpectrumData.empty())
+            return false;
+
+        const int w = waterfall.getWidth();
+        waterfallRow = (waterfallRow + waterfall.getHeight() - 1) % waterfall.getHeight();
+        waterfallValues.resize(static_cast<size_t>(waterfallAxis.getNumColumns()));
+        waterfallAxis.mapSpectrum(postSpectrumData.data(), static_cast<int>(postSpectrumData.size()),
+                                  waterfallValues.data(), spectrumReduction);
+
+        juce::Image::BitmapData row(waterfall, 0, waterfallRow, w, 1, juce::Image::BitmapData::writeOnly);
+        const int numColumns = juce::jmin(w, static_cast<int>(waterfallValues.size()));
+        for (int x = 0; x < numColumns; ++x)
+        {
+            const int index = juce::jlimit(0, 255, static_cast<int>(waterfallValues[static_cast<size_t>(x)] * 255.0f));
+            reinterpret_cast<juce::PixelRGB *>(row.getPixelPointer(x, 0))->set(waterfallColours[static_cast<size_t>(index)]);
+        }
+
+        return true;
+    }
+
+    void drawWaterfall(juce::Graphics &g)
+    {
+        const int w = waterfall.getWidth();
+        const int h = waterfall.getHeight();
+        const auto toLogical = juce::AffineTransform::scale(1.0f / waterfallScale);
+
+        g.drawImageTransformed(waterfall.getClippedImage({0, waterfallRow, w, h - waterfallRow}), toLogical);
+        if (waterfallRow > 0)
+            g.drawImageTransformed(waterfall.getClippedImage({0, 0, w, waterfallRow}),
+                                   toLogical.translated(0.0f, static_cast<float>(h - waterfallRow) / waterfallScale));
+    }
+
+    void recordPaintTime(juce::int64 ticks)
+    {
+        const double ms = juce::Time::highResolutionTicksToSeconds(ticks) * 1000.0;
+        paintStats.meanMs = paintStats.numFrames == 0 ? ms : paintStats.meanMs + 0.02 * (ms - paintStats.meanMs);
+        paintStats.maxMs = juce::jmax(paintStats.maxMs, ms);
+        ++paintStats.numFrames;
+    }
+
+    //==============================================================================
+    // Right-click menu with the analyzer display settings
+    void showAnalyzerMenu()
+    {
+        juce::Component::SafePointer<SpectrumComponent> safeThis(this);
+        auto setReduction = [safeThis](SpectrumAxis::Reduction r)
+        {
+            if (safeThis != nullptr)
+            {
+                safeThis->spectrumReduction = r;
+                safeThis->repaint();
+            }
+        };
+
+        juce::PopupMenu menu;
+        menu.addSectionHeader(juce::String::fromUTF8("\u9891\u8c31\u663e\u793a"));              // Analyzer display
+        menu.addItem(juce::String::fromUTF8("\u5cf0\u503c"),                                      // Peak
+                     true, spectrumReduction == SpectrumAxis::Reduction::Peak,
+                     [setReduction]() { setReduction(SpectrumAxis::Reduction::Peak); });
+        menu.addItem(juce::String::fromUTF8("\u529f\u7387\u5e73\u5747"),                        // Power average
+                     true, spectrumReduction == SpectrumAxis::Reduction::PowerAverage,
+                     [setReduction]() { setReduction(SpectrumAxis::Reduction::PowerAverage); });
+        menu.addItem(juce::String::fromUTF8("\u7011\u5e03\u56fe"),                              // Waterfall
+                     true, showWaterfall,
+                     [safeThis]()
+                     {
+                         if (safeThis != nullptr)
+                         {
+                             safeThis->showWaterfall = !safeThis->showWaterfall;
+                             safeThis->waterfall = {};
+                             safeThis->repaint();
+                         }
+                     });
+
+        // Fractional-octave smoothing, applied by both analyzers
+        using Smoothing = SpectrumAnalyzer::Smoothing;
+        const auto currentSmoothing = processor.getPostSpectrumAnalyzer().getSmoothing();
+        juce::PopupMenu smoothingMenu;
+        const std::pair<Smoothing, const char *> smoothingItems[] = {
+            {Smoothing::off, "\u5173"},                                                       // Off
+            {Smoothing::third, "1/3 \u500d\u9891\u7a0b"},                                       // 1/3 octave
+            {Smoothing::sixth, "1/6 \u500d\u9891\u7a0b"},
+            {Smoothing::twelfth, "1/12 \u500d\u9891\u7a0b"},
+            {Smoothing::twentyFourth, "1/24 \u500d\u9891\u7a0b"},
+        };
+        for (const auto &[mode, name] : smoothingItems)
+        {
+            smoothingMenu.addItem(juce::String::fromUTF8(name), true, mode == currentSmoothing,
+                                  [safeThis, mode = mode]()
+                                  {
+                                      if (safeThis != nullptr)
+                                      {
+                                          safeThis->processor.getPreSpectrumAnalyzer().setSmoothing(mode);
+                                          safeThis->processor.getPostSpectrumAnalyzer().setSmoothing(mode);
+                                      }
+                                  });
+        }
+        menu.addSubMenu(juce::String::fromUTF8("\u5e73\u6ed1"), smoothingMenu);                 // Smoothing
+
+        // FFT size / overlap / window, shared by both analyzers
+        using Config = SpectrumAnalyzer::Config;
+        const auto config = processor.getAnalyzerConfig();
+        auto setConfig = [safeThis](Config c)
+        {
+            if (safeThis != nullptr)
+                safeThis->processor.setAnalyzerConfig(c);
+        };
+
+        juce::PopupMenu resolutionMenu;
+        for (int order = SpectrumAnalyzer::minFFTOrder; order <= SpectrumAnalyzer::maxFFTOrder; ++order)
+        {
+            auto c = config;
+            c.fftOrder = order;
+            resolutionMenu.addItem(juce::String(1 << order) + juce::String::fromUTF8(" \u70b9"),   // N points
+                                   true, order == config.fftOrder, [setConfig, c]() { setConfig(c); });
+        }
+        menu.addSubMenu(juce::String::fromUTF8("\u5206\u8fa8\u7387"), resolutionMenu);            // Resolution
+
+        using Overlap = SpectrumAnalyzer::Overlap;
+        juce::PopupMenu overlapMenu;
+        const std::pair<Overlap, const char *> overlapItems[] = {
+            {Overlap::half, "50%"},
+            {Overlap::threeQuarters, "75%"},
+            {Overlap::sevenEighths, "87.5%"},
+        };
+        for (const auto &[overlap, name] : overlapItems)
+        {
+            auto c = config;
+            c.overlap = overlap;
+            overlapMenu.addItem(name, true, overlap == config.overlap, [setConfig, c]() { setConfig(c); });
+        }
+        menu.addSubMenu(juce::String::fromUTF8("\u91cd\u53e0"), overlapMenu);                   // Overlap
+
+        using Window = SpectrumAnalyzer::Window;
+        juce::PopupMenu windowMenu;
+        const std::pair<Window, const char *> windowItems[] = {
+            {Window::hann, "Hann"},
+            {Window::blackmanHarris, "Blackman-Harris"},
+            {Window::flatTop, "\u5e73\u9876"},                                              // Flat top
+            {Window::rectangular, "\u77e9\u5f62"},                                          // Rectangular
+        };
+        for (const auto &[window, name] : windowItems)
+        {
+            auto c = config;
+            c.window = window;
+            windowMenu.addItem(juce::String::fromUTF8(name), true, window == config.window,
+                               [setConfig, c]() { setConfig(c); });
+        }
+        menu.addSubMenu(juce::String::fromUTF8("\u7a97\u51fd\u6570"), windowMenu);               // Window
+
+        addTraceItems(menu);
+        addMatchItems(menu);
+        addResonanceItems(menu);
+
+        menu.addSeparator();
+        menu.addItem(juce::String::fromUTF8("\u663e\u793a\u5e27\u7387"),                        // Show frame rate
+                     true, showFrameStats,
+                     [safeThis]()
+                     {
+                         if (safeThis != nullptr)
+                         {
+                             safeThis->showFrameStats = !safeThis->showFrameStats;
+                             safeThis->repaint();
+                         }
+                     });
+
+        menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this).withMousePosition());
+    }
+
+    // Peak-hold / long-term average / max-hold settings; they apply to the post-EQ spectrum
+    void addTraceItems(juce::PopupMenu &menu)
+    {
+        auto &traces = analysisJob.getPostTraces();
+        juce::Component::SafePointer<SpectrumComponent> safeThis(this);
+        auto withTraces = [safeThis](auto change)
+        {
+            return [safeThis, change]()
+            {
+                if (safeThis != nullptr)
+                {
+                    change(safeThis->analysisJob.getPostTraces());
+                    safeThis->repaint();
+                }
+            };
+        };
+
+        menu.addSeparator();
+
+        juce::PopupMenu peakHoldMenu;
+        const bool peakHold = traces.isPeakHoldEnabled();
+        peakHoldMenu.addItem(juce::String::fromUTF8("\u5173"), true, !peakHold,                   // Off
+                             withTraces([](SpectrumTraces &t) { t.setPeakHold(false, t.getPeakHoldSeconds()); }));
+        const std::pair<float, const char *> holdItems[] = {
+            {1.0f, "1 s"},
+            {3.0f, "3 s"},
+            {10.0f, "10 s"},
+            {SpectrumTraces::infiniteHold, "\u65e0\u9650"},                                      // Infinite
+        };
+        for (const auto &[seconds, name] : holdItems)
+        {
+            peakHoldMenu.addItem(juce::String::fromUTF8(name), true,
+                                 peakHold && traces.getPeakHoldSeconds() == seconds,
+                                 withTraces([seconds = seconds](SpectrumTraces &t) { t.setPeakHold(true, seconds); }));
+        }
+        menu.addSubMenu(juce::String::fromUTF8("\u5cf0\u503c\u4fdd\u6301"), peakHoldMenu);       // Peak hold
+
+        using Averaging = SpectrumTraces::Averaging;
+        juce::PopupMenu averageMenu;
+        const bool average = traces.isAverageEnabled();
+        const auto averaging = traces.getAveraging();
+        const float averageSeconds = traces.getAverageSeconds();
+        averageMenu.addItem(juce::String::fromUTF8("\u5173"), true, !average,                     // Off
+                            withTraces([](SpectrumTraces &t) { t.setAverage(false, t.getAveraging(), t.getAverageSeconds()); }));
+        averageMenu.addItem(juce::String::fromUTF8("\u6307\u6570"), true,                         // Exponential
+                            average && averaging == Averaging::exponential,
+                            withTraces([](SpectrumTraces &t) { t.setAverage(true, Averaging::exponential, t.getAverageSeconds()); }));
+        averageMenu.addItem(juce::String::fromUTF8("\u7ebf\u6027"), true,                         // Linear
+                            average && averaging == Averaging::linear,
+                            withTraces([](SpectrumTraces &t) { t.setAverage(true, Averaging::linear, t.getAverageSeconds()); }));
+        averageMenu.addSeparator();
+        const std::pair<float, const char *> windowItems[] = {
+            {3.0f, "3 s"},
+            {10.0f, "10 s"},
+            {30.0f, "30 s"},
+            {60.0f, "1 min"},
+            {180.0f, "3 min"},
+        };
+        for (const auto &[seconds, name] : windowItems)
+        {
+            averageMenu.addItem(name, true, averageSeconds == seconds,
+                                withTraces([seconds = seconds](SpectrumTraces &t)
+                                           { t.setAverage(t.isAverageEnabled(), t.getAveraging(), seconds); }));
+        }
+        menu.addSubMenu(juce::String::fromUTF8("\u957f\u671f\u5e73\u5747"), averageMenu);        // Long-term average
+
+        menu.addItem(juce::String::fromUTF8("\u6700\u5927\u503c\u4fdd\u6301"),                 // Max hold
+                     true, traces.isMaxHoldEnabled(),
+                     withTraces([](SpectrumTraces &t) { t.setMaxHold(!t.isMaxHoldEnabled()); }));
+        menu.addItem(juce::String::fromUTF8("\u91cd\u7f6e\u66f2\u7ebf"),                        // Reset traces
+                     traces.isAnyEnabled(),
+                     false,
+                     withTraces([](SpectrumTraces &t) { t.reset(); }));
+    }
+
+    // Match EQ: capture a reference (live input or file) and a source (live input), then fit
+    // the bands to reference - source
+    void addMatchItems(juce::PopupMenu &menu)
+    {
+        juce::Component::SafePointer<SpectrumComponent> safeThis(this);
+        auto *capturing = analysisJob.getInputCapture();
+        const bool hasFileReference = fileReference.isValid();
+        const int referenceFrames = referenceCapture.getNumFrames();
+        const int sourceFrames = sourceCapture.getNumFrames();
+
+        // Starting a capture restarts it; a captured reference replaces a file one
+        auto toggleCapture = [safeThis](SpectrumCapture *target)
+        {
+            return [safeThis, target]()
+            {
+                if (safeThis == nullptr)
+                    return;
+
+                auto &job = safeThis->analysisJob;
+                if (job.getInputCapture() == target)
+                {
+                    job.setInputCapture(nullptr);
+                    return;
+                }
+
+                target->reset();
+                if (target == &safeThis->referenceCapture)
+                    safeThis->fileReference = {};
+                job.setInputCapture(target);
+            };
+        };
+
+        juce::PopupMenu matchMenu;
+        matchMenu.addItem(juce::String::fromUTF8("\u6355\u83b7\u53c2\u8003 (\u8f93\u5165)"),   // Capture reference (input)
+                          !matchBusy, capturing == &referenceCapture,
+                          toggleCapture(&referenceCapture));
+        matchMenu.addItem(juce::String::fromUTF8("\u4ece\u6587\u4ef6\u8f7d\u5165\u53c2\u8003..."),   // Load reference from file...
+                          !matchBusy, false,
+                          [safeThis]()
+                          {
+                              if (safeThis != nullptr)
+                                  safeThis->chooseReferenceFile();
+                          });
+        matchMenu.addItem(juce::String::fromUTF8("\u6355\u83b7\u6e90 (\u8f93\u5165)"),           // Capture source (input)
+                          !matchBusy, capturing == &sourceCapture,
+                          toggleCapture(&sourceCapture));
+
+        matchMenu.addSeparator();
+        const bool canFit = !matchBusy && (hasFileReference || referenceFrames > 0) && sourceFrames > 0;
+        matchMenu.addItem(juce::String::fromUTF8("\u62df\u5408\u5e76\u5e94\u7528"),              // Fit and apply
+                          canFit, false,
+                          [safeThis]()
+                          {
+                              if (safeThis != nullptr)
+                                  safeThis->startMatchFit();
+                          });
+        matchMenu.addItem(juce::String::fromUTF8("\u6e05\u9664"),                                 // Clear
+                          !matchBusy, false,
+                          [safeThis]()
+                          {
+                              if (safeThis == nullptr)
+                                  return;
+                              safeThis->analysisJob.setInputCapture(nullptr);
+                              safeThis->referenceCapture.reset();
+                              safeThis->sourceCapture.reset();
+                              safeThis->fileReference = {};
+                              safeThis->matchStatus = {};
+                          });
+
+        // Status lines
+        const auto frames = juce::String::fromUTF8(" \u5e27");                                    // frames
+        matchMenu.addSeparator();
+        matchMenu.addItem(juce::String::fromUTF8("\u53c2\u8003: ")                                // Reference:
+                              + (hasFileReference ? juce::String::fromUTF8("\u6587\u4ef6")        // File
+                                                  : juce::String(referenceFrames) + frames),
+                          false, false, [] {});
+        matchMenu.addItem(juce::String::fromUTF8("\u6e90: ") + juce::String(sourceFrames) + frames,   // Source:
+                          false, false, [] {});
+        if (matchStatus.isNotEmpty())
+            matchMenu.addItem(matchStatus, false, false, [] {});
+
+        menu.addSubMenu(juce::String::fromUTF8("\u5339\u914d EQ"), matchMenu);                   // Match EQ
+    }
+
+    void chooseReferenceFile()
+    {
+        referenceChooser = std::make_unique<juce::FileChooser>(
+            juce::String::fromUTF8("\u9009\u62e9\u53c2\u8003\u97f3\u9891"),                        // Choose reference audio
+            juce::File(), "*.wav;*.aif;*.aiff;*.flac;*.ogg;*.mp3");
+
+        juce::Component::SafePointer<SpectrumComponent> safeThis(this);
+        referenceChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                      [safeThis](const juce::FileChooser &chooser)
+                                      {
+                                          const auto file = chooser.getResult();
+                                          if (safeThis == nullptr || file == juce::File())
+                                              return;
+
+                                          safeThis->matchBusy = true;
+                                          safeThis->matchStatus = juce::String::fromUTF8("\u8f7d\u5165\u4e2d...");   // Loading...
+                                          juce::Thread::launch([safeThis, file]()
+                                          {
+                                              auto spectrum = MatchSpectrum::fromFile(file);
+                                              juce::MessageManager::callAsync([safeThis, spectrum]()
+                                              {
+                                                  if (safeThis != nullptr)
+                                                      safeThis->referenceLoaded(spectrum);
+                                              });
+                                          });
+                                      });
+    }
+
+    void referenceLoaded(const MatchSpectrum &spectrum)
+    {
+        matchBusy = false;
+        if (!spectrum.isValid())
+        {
+            matchStatus = juce::String::fromUTF8("\u8f7d\u5165\u5931\u8d25");                       // Loading failed
+            return;
+        }
+
+        if (analysisJob.getInputCapture() == &referenceCapture)
+            analysisJob.setInputCapture(nullptr);
+        referenceCapture.reset();
+        fileReference = spectrum;
+        matchStatus = {};
+    }
+
+    void startMatchFit()
+    {
+        const auto reference = fileReference.isValid() ? fileReference : referenceCapture.getSpectrum();
+        const auto source = sourceCapture.getSpectrum();
+        const double sampleRate = processor.getCurrentSampleRate() > 0.0 ? processor.getCurrentSampleRate() : 44100.0;
+        const int numBands = matchFitBands;
+
+        matchBusy = true;
+        matchStatus = juce::String::fromUTF8("\u62df\u5408\u4e2d...");                               // Fitting...
+
+        juce::Component::SafePointer<SpectrumComponent> safeThis(this);
+        juce::Thread::launch([safeThis, reference, source, sampleRate, numBands]()
+        {
+            MatchEQFitter fitter(sampleRate);
+            auto result = fitter.fit(reference, source, numBands);
+            juce::MessageManager::callAsync([safeThis, result]()
+            {
+                if (safeThis != nullptr)
+                    safeThis->applyMatchFit(result);
+            });
+        });
+    }
+
+    // Static bands: the fit matches the long-term average, not dynamics
+    void applyMatchFit(const MatchEQFitter::Result &result)
+    {
+        matchBusy = false;
+        if (result.bands.empty())
+        {
+            matchStatus = {};
+            return;
+        }
+
+        processor.setActiveBandCount(static_cast<int>(result.bands.size()));
+        for (size_t b = 0; b < result.bands.size(); ++b)
+            processor.setBandShape(static_cast<int>(b), result.bands[b]);
+
+        matchStatus = juce::String::fromUTF8("\u8bef\u5dee ") + juce::String(result.rmsErrorDB, 2)   // Error
+                    + " dB, " + juce::String(result.milliseconds, 1) + " ms";
+    }
+
+    // Resonance search on the post-EQ spectrum, and placing its suggestions as dynamic bands
+    void addResonanceItems(juce::PopupMenu &menu)
+    {
+        juce::Component::SafePointer<SpectrumComponent> safeThis(this);
+        const bool detecting = analysisJob.isResonanceDetectionEnabled();
+
+        menu.addItem(juce::String::fromUTF8("\u67e5\u627e\u5171\u632f"),                        // Find resonances
+                     true, detecting,
+                     [safeThis, detecting]()
+                     {
+                         if (safeThis == nullptr)
+                             return;
+                         safeThis->analysisJob.setResonanceDetection(!detecting);
+                         safeThis->resonanceSuggestions.clear();
+                         safeThis->repaint();
+                     });
+
+        const bool canPlace = detecting && !resonanceSuggestions.empty()
+                           && processor.getActiveBandCount() < DynamicEQAudioProcessor::numBands;
+        menu.addItem(juce::String::fromUTF8("\u653e\u7f6e\u5efa\u8bae\u9891\u6bb5")               // Place suggested bands
+                         + " (" + juce::String(static_cast<int>(resonanceSuggestions.size())) + ")",
+                     canPlace, false,
+                     [safeThis]()
+                     {
+                         if (safeThis != nullptr)
+                             safeThis->placeResonanceBands();
+                     });
+    }
+
+    // Appends a dynamic Peak band per suggestion, strongest first, while bands are free.
+    // Resonances within 1/6 octave of an active band are left to that band. Thresholds sit
+    // above the detectors' long-term level, so steady material passes untouched.
+    void placeResonanceBands()
+    {
+        auto &apvts = processor.getAPVTS();
+        int numActive = processor.getActiveBandCount();
+        const float thresholdDB = ResonanceDetector::getBandThresholdDB(processor.getDetectorLevelDB());
+
+        std::vector<float> occupied;
+        for (int b = 0; b < numActive; ++b)
+            occupied.push_back(apvts.getRawParameterValue("band" + juce::String(b) + "_freq")->load());
+
+        for (const auto &s : resonanceSuggestions)
+        {
+            if (numActive >= DynamicEQAudioProcessor::numBands)
+                break;
+
+            const bool covered = std::any_of(occupied.begin(), occupied.end(), [&s](float f)
+                                             { return std::abs(std::log2(f / s.frequency)) < 1.0f / 6.0f; });
+            if (covered)
+                continue;
+
+            BandParams band;
+            band.type = BandParams::FilterType::Peak;
+            band.frequency = s.frequency;
+            band.gain = 0.0f;   // cut only while the signal rises above its usual level
+            band.q = s.q;
+            band.enabled = true;
+            band.dynamicOn = true;
+
+            processor.setActiveBandCount(numActive + 1);
+            processor.setBandShape(numActive, band);
+            processor.setBandParameter(numActive, "threshold", thresholdDB);
+            occupied.push_back(s.frequency);
+            ++numActive;
+        }
+    }
 
     //==============================================================================
-    void timerCallback() override
+    // Frame pacing: driven by the display's vblank, at most 60 analyzer frames per second.
+    // The rate drops (down to 15 fps) while the average paint time exceeds its share of the
+    // frame, recovers when painting is cheap again, and stops while the window is hidden.
+    //==============================================================================
+    static constexpr double minFrameIntervalMs = 1000.0 / 60.0;
+    static constexpr double maxFrameIntervalMs = 1000.0 / 15.0;
+    static constexpr double paintBudgetFraction = 0.25;   // of the frame interval
+    static constexpr int framesPerAdaptation = 30;
+
+    juce::VBlankAttachment vblankAttachment{this, [this] { onVBlank(); }};
+    double frameIntervalMs = minFrameIntervalMs;
+    double lastVBlankMs = 0.0, vblankPeriodMs = minFrameIntervalMs;
+    double lastFrameMs = 0.0, frameRateHz = 0.0;
+    int framesSinceAdaptation = 0;
+    bool showFrameStats = false;
+
+    void onVBlank()
     {
-        // Process pre/post spectrum FFT
-        auto &preSA = processor.getPreSpectrumAnalyzer();
-        auto &postSA = processor.getPostSpectrumAnalyzer();
+        const double now = juce::Time::getMillisecondCounterHiRes();
+        if (lastVBlankMs > 0.0)
+            vblankPeriodMs += 0.1 * (juce::jlimit(1.0, 100.0, now - lastVBlankMs) - vblankPeriodMs);
+        lastVBlankMs = now;
+
+        // Occluded or minimised: no analysis, no painting
+        auto *peer = getPeer();
+        if (!isShowing() || peer == nullptr || peer->isMinimised())
+        {
+            analysisJob.setPriority(AnalysisScheduler::Priority::hidden, frameIntervalMs);
+            return;
+        }
+
+        // Analysis runs at the paint rate while the user is looking at this editor
+        const bool focused = peer->isFocused() || isMouseOverOrDragging(true);
+        analysisJob.setPriority(focused ? AnalysisScheduler::Priority::focused
+                                        : AnalysisScheduler::Priority::background,
+                                frameIntervalMs);
+
+        // Wait for the next due frame, to the nearest vblank
+        const double sinceLast = now - lastFrameMs;
+        if (sinceLast + 0.5 * vblankPeriodMs < frameIntervalMs)
+            return;
 
-        if (preSA.isNewDataAvailable())
-            preSA.processFFT(preSpectrumData);
+        lastFrameMs = now;
+        const double dtSeconds = juce::jlimit(minFrameIntervalMs, 250.0, sinceLast) * 0.001;
+        frameRateHz += 0.1 * (1.0 / dtSeconds - frameRateHz);
 
-        if (postSA.isNewDataAvailable())
-            postSA.processFFT(postSpectrumData);
+        if (++framesSinceAdaptation >= framesPerAdaptation)
+        {
+            framesSinceAdaptation = 0;
+            adaptFrameRate();
+        }
+
+        advanceFrame(static_cast<float>(dtSeconds));
+
+        if (showFrameStats)
+            repaint(getFrameStatsArea());
+    }
 
-        // Smooth the spectrum data
-        const float attackSmooth  = 0.20f;
-        const float releaseSmooth = 0.97f;
+    void adaptFrameRate()
+    {
+        const double budgetMs = frameIntervalMs * paintBudgetFraction;
+        if (paintStats.meanMs > budgetMs)
+            frameIntervalMs = juce::jmin(maxFrameIntervalMs, frameIntervalMs * 1.25);
+        else if (paintStats.meanMs < 0.5 * budgetMs)
+            frameIntervalMs = juce::jmax(minFrameIntervalMs, frameIntervalMs / 1.1);
+    }
+
+    juce::Rectangle<int> getFrameStatsArea() const
+    {
+        return getLocalBounds().removeFromTop(18).removeFromRight(260).reduced(4, 2);
+    }
+
+    void drawFrameStats(juce::Graphics &g)
+    {
+        auto area = getFrameStatsArea();
+        g.setColour(juce::Colour(0xC0101020));
+        g.fillRect(area);
+        g.setColour(juce::Colour(0xFF9AA5D6));
+        g.setFont(juce::FontOptions(10.0f));
+        g.drawText(juce::String(frameRateHz, 1) + " fps (max " + juce::String(1000.0 / frameIntervalMs, 0)
+                       + ")  paint " + juce::String(paintStats.meanMs, 2) + " / "
+                       + juce::String(paintStats.maxMs, 2) + " ms",
+                   area, juce::Justification::centred);
+    }
+
+    //==============================================================================
+    void advanceFrame(float dtSeconds)
+    {
+        // Newest pre/post frame from the analysis workers, if any
+        const bool newFrame = analysisJob.pullFrame(preSpectrumData, postSpectrumData);
+
+        // Resolution changed: restart the traces at the new bin count
+        if (preSpectrumData.size() != smoothedPreSpectrum.size()
+            || postSpectrumData.size() != smoothedPreSpectrum.size())
+            resizeSpectra();
+
+        const bool waterfallScrolled = showWaterfall && newFrame && pushWaterfallRow();
+        const bool tracesChanged = analysisJob.pullTraces(peakHoldTrace, averageTrace, maxHoldTrace);
+        const bool resonancesChanged = analysisJob.isResonanceDetectionEnabled()
+                                    && analysisJob.pullResonances(resonanceSuggestions);
+
+        // Smooth the spectrum data, tracking the largest move since the last repaint.
+        // The coefficients are per 1/60 s, scaled to the actual frame interval.
+        const float ticks = dtSeconds * 60.0f;
+        const float attackSmooth  = std::pow(0.20f, ticks);
+        const float releaseSmooth = std::pow(0.97f, ticks);
+        float maxDelta = 0.0f;
         for (size_t i = 0; i < smoothedPreSpectrum.size(); ++i)
         {
             float preCoeff  = preSpectrumData[i]  > smoothedPreSpectrum[i]  ? attackSmooth  : releaseSmooth;
             float postCoeff = postSpectrumData[i] > smoothedPostSpectrum[i] ? attackSmooth  : releaseSmooth;
             smoothedPreSpectrum[i]  = preCoeff  * smoothedPreSpectrum[i]  + (1.0f - preCoeff)  * preSpectrumData[i];
             smoothedPostSpectrum[i] = postCoeff * smoothedPostSpectrum[i] + (1.0f - postCoeff) * postSpectrumData[i];
+
+            maxDelta = juce::jmax(maxDelta, std::abs(smoothedPreSpectrum[i] - paintedPreSpectrum[i]),
+                                  std::abs(smoothedPostSpectrum[i] - paintedPostSpectrum[i]));
         }
 
+        const bool spectrumMoved = maxDelta * static_cast<float>(getHeight()) > repaintThresholdPx;
+
+        // Pull gain-reduction frames written since the last tick
+        const bool trailsChanged = pullGainReductionHistory(ticks);
+
         // Check if curve parameters changed
-        checkAndUpdateCurve();
+        const bool curveChanged = checkAndUpdateCurve();
 
+        if (!(spectrumMoved || trailsChanged || curveChanged || waterfallScrolled || tracesChanged || resonancesChanged))
+            return;
+
+        paintedPreSpectrum = smoothedPreSpectrum;
+        paintedPostSpectrum = smoothedPostSpectrum;
         repaint();
     }
 
+    void resizeSpectra()
+    {
+        const auto numBins = juce::jmin(preSpectrumData.size(), postSpectrumData.size());
+        preSpectrumData.resize(numBins, 0.0f);
+        postSpectrumData.resize(numBins, 0.0f);
+
+        for (auto *trace : {&smoothedPreSpectrum, &smoothedPostSpectrum, &paintedPreSpectrum, &paintedPostSpectrum})
+            trace->assign(numBins, 0.0f);
+
+        axis.setSampleRate(processor.getCurrentSampleRate(), static_cast<int>(numBins) * 2);
+        waterfallAxis.setSampleRate(processor.getCurrentSampleRate(), static_cast<int>(numBins) * 2);
+        repaint();
+    }
+
+    //==============================================================================
+    // Hover / drag feedback only touches the node's own area
+    void setHoveredBand(int band)
+    {
+        if (band == hoveredBand)
+            return;
+
+        repaintNode(hoveredBand);
+        hoveredBand = band;
+        repaintNode(hoveredBand);
+    }
+
+    void repaintNode(int bandIndex)
+    {
+        if (!juce::isPositiveAndBelow(bandIndex, processor.getActiveBandCount()))
+            return;
+
+        auto &apvts = processor.getAPVTS();
+        auto prefix = "band" + juce::String(bandIndex) + "_";
+        float freq = apvts.getRawParameterValue(prefix + "freq")->load();
+        float gain = apvts.getRawParameterValue(prefix + "gain")->load();
+        int   type = static_cast<int>(apvts.getRawParameterValue(prefix + "type")->load());
+        float displayGain = (type >= 3) ? 0.0f : (gain - processor.getBandGainReduction(bandIndex));
+
+        // Largest glow (hovered + dragged) plus the GR label to the right of the node
+        const float reach = glowRadius + 14.0f;
+        juce::Rectangle<float> area(axis.freqToX(freq) - reach, axis.dbToY(displayGain) - reach,
+                                    reach * 2.0f + 62.0f, reach * 2.0f);
+        repaint(area.getSmallestIntegerContainer());
+    }
+
     //==============================================================================
-    // Check if any band parameters changed and recalculate curves if needed
+    // Fold new history frames into each band's trail columns and peak meter
     //==============================================================================
-    void checkAndUpdateCurve()
+    // Returns true if any trail or meter changed visibly
+    bool pullGainReductionHistory(float ticks)
+    {
+        bool changed = false;
+        const auto &history = processor.getGainReductionHistory();
+        const int active = syncBandStorage();
+
+        for (int b = 0; b < active; ++b)
+        {
+            auto &trail = grTrails[static_cast<size_t>(b)];
+            if (trail.nextFrame < 0)
+                trail.nextFrame = history.getWriteCount(b);
+
+            const int num = history.readFrames(b, trail.nextFrame, grReadBuffer.data(), GRHistory::capacity);
+
+            float peak = 0.0f;
+            for (int i = 0; i < num; ++i)
+            {
+                const float frameMax = grReadBuffer[static_cast<size_t>(i)].maxDB;
+                peak = juce::jmax(peak, frameMax);
+
+                trail.columnMax = juce::jmax(trail.columnMax, frameMax);
+                if (++trail.columnFrames >= grFramesPerColumn)
+                {
+                    auto &column = trail.columns[static_cast<size_t>(trail.head)];
+                    const bool wasVisible = column > grVisibleDB;
+                    trail.numVisibleColumns += (trail.columnMax > grVisibleDB ? 1 : 0) - (wasVisible ? 1 : 0);
+                    column = trail.columnMax;
+                    trail.head = (trail.head + 1) % grTrailColumns;
+
+                    // The trail scrolls whenever it shows anything (or just lost its last column)
+                    changed = changed || trail.numVisibleColumns > 0 || wasVisible;
+                    trail.columnMax = 0.0f;
+                    trail.columnFrames = 0;
+                }
+            }
+
+            const float newPeak = juce::jmax(peak, trail.meterPeak - grMeterFallDB * ticks);
+            changed = changed || (newPeak != trail.meterPeak && juce::jmax(newPeak, trail.meterPeak) > grVisibleDB);
+            trail.meterPeak = newPeak;
+        }
+
+        return changed;
+    }
+
+    //==============================================================================
+    // Check which bands changed and recompute only their curves.
+    // Returns true if the curves (and so the nodes) need repainting.
+    //==============================================================================
+    bool checkAndUpdateCurve()
     {
         auto &apvts = processor.getAPVTS();
-        bool changed = curveNeedsUpdate;
 
-        // Force rebuild whenever active band count changes
-        int active = processor.getActiveBandCount();
+        // Width or sample rate changed: every band's sampling grid is stale
+        const double sr = processor.getCurrentSampleRate();
+        if (sr != curveSampleRate)
+        {
+            curveSampleRate = sr;
+            curveNeedsUpdate = true;
+            axis.setSampleRate(sr, static_cast<int>(smoothedPreSpectrum.size()) * 2);
+            waterfallAxis.setSampleRate(sr, static_cast<int>(smoothedPreSpectrum.size()) * 2);
+        }
+
+        if (curveNeedsUpdate)
+        {
+            std::fill(bandCurveDirty.begin(), bandCurveDirty.end(), true);
+            totalCurveDirty = true;
+        }
+
+        // Added / removed bands change the product even if no band changed
+        int active = syncBandStorage();
         if (active != lastActiveBandCount)
         {
+            for (int i = juce::jmax(0, lastActiveBandCount); i < active; ++i)
+                bandCurveDirty[static_cast<size_t>(i)] = true;
             lastActiveBandCount = active;
-            changed = true;
+            totalCurveDirty = true;
         }
 
         for (int i = 0; i < active; ++i)
@@ -263,123 +1122,99 @@ private:
             auto &last = lastSnapshots[static_cast<size_t>(i)];
             if (snap.freq != last.freq || snap.gain != last.gain || snap.q != last.q || snap.type != last.type || snap.enabled != last.enabled || snap.dynamic != last.dynamic || std::abs(snap.gr - last.gr) > 0.05f)
             {
-                changed = true;
+                bandCurveDirty[static_cast<size_t>(i)] = true;
                 last = snap;
             }
         }
 
-        if (changed)
-            rebuildCurveCache();
+        return updateCurveCache(active);
     }
 
-    void rebuildCurveCache()
+    // Per-band curves, snapshots and trails exist for the active bands only (up to 32 of
+    // them); every per-band loop goes through here first
+    int syncBandStorage()
     {
-        curveNeedsUpdate = false;
-        const double sr = processor.getCurrentSampleRate();
-        if (sr <= 0.0)
-            return;
+        const int active = processor.getActiveBandCount();
+        if (active != static_cast<int>(lastSnapshots.size()))
+        {
+            const auto n = static_cast<size_t>(active);
+            cachedBandMagnitudes.resize(n);
+            bandCurveDirty.resize(n, true);
+            lastSnapshots.resize(n);
+            grTrails.resize(n);
+        }
+        return active;
+    }
 
+    bool updateCurveCache(int activeBands)
+    {
         const float width = static_cast<float>(getWidth());
-        if (width <= 0.0f)
-            return;
+        if (curveSampleRate <= 0.0 || width <= 0.0f)
+            return false;
 
-        // Build frequency array for sampling points
-        for (int i = 0; i < curveNumPoints; ++i)
+        if (curveNeedsUpdate)
         {
-            float t = static_cast<float>(i) / static_cast<float>(curveNumPoints - 1);
-            float x = t * width;
-            curveFrequencies[static_cast<size_t>(i)] = static_cast<double>(xToFreq(x, width, minFreqHz, maxFreqHz));
-        }
+            curveNeedsUpdate = false;
+
+            // Frequency of each sampling point across the current width
+            for (int i = 0; i < curveNumPoints; ++i)
+            {
+                float t = static_cast<float>(i) / static_cast<float>(curveNumPoints - 1);
+                float x = t * width;
+                curveFrequencies[static_cast<size_t>(i)] = static_cast<double>(axis.xToFreq(x));
+            }
 
-        // Reset total (start at 1.0 in linear for multiplicative accumulation)
-        std::array<double, curveNumPoints> totalLinearMagnitude{};
-        totalLinearMagnitude.fill(1.0);
+            curveResponse.prepare(curveFrequencies.data(), curveNumPoints, curveSampleRate);
+        }
 
-        // Compute each band's magnitude response using JUCE's built-in method
-        int activeBands = processor.getActiveBandCount();
         for (int b = 0; b < activeBands; ++b)
         {
-            auto &snap = lastSnapshots[static_cast<size_t>(b)];
-            auto &bandMag = cachedBandMagnitudes[static_cast<size_t>(b)];
-
-            if (!snap.enabled)
-            {
-                bandMag.fill(0.0f);
+            if (!bandCurveDirty[static_cast<size_t>(b)])
                 continue;
-            }
 
-            float effectiveGain = snap.gain;
-            if (snap.dynamic)
-                effectiveGain -= snap.gr;
+            rebuildBandCurve(b);
+            bandCurveDirty[static_cast<size_t>(b)] = false;
+            totalCurveDirty = true;
+        }
 
-            // Build filter coefficients once per band
-            juce::dsp::IIR::Coefficients<float>::Ptr coeffs;
-            float gainFactor = juce::Decibels::decibelsToGain(effectiveGain);
+        if (!totalCurveDirty)
+            return false;
 
-            switch (snap.type)
-            {
-            case 0:
-                coeffs = juce::dsp::IIR::Coefficients<float>::makeLowShelf(sr, snap.freq, snap.q, gainFactor);
-                break;
-            case 1:
-                coeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sr, snap.freq, snap.q, gainFactor);
-                break;
-            case 2:
-                coeffs = juce::dsp::IIR::Coefficients<float>::makeHighShelf(sr, snap.freq, snap.q, gainFactor);
-                break;
-            case 3: // Low Cut (High Pass)
-                coeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(sr, snap.freq, snap.q);
-                break;
-            case 4: // High Cut (Low Pass)
-                coeffs = juce::dsp::IIR::Coefficients<float>::makeLowPass(sr, snap.freq, snap.q);
-                break;
-            case 5: // Notch
-            {
-                // Standard biquad notch computed manually
-                float w0    = juce::MathConstants<float>::twoPi * snap.freq / static_cast<float>(sr);
-                float cosW0 = std::cos(w0);
-                float alpha = std::sin(w0) / (2.0f * snap.q);
-                coeffs = new juce::dsp::IIR::Coefficients<float> (
-                    1.0f, -2.0f * cosW0, 1.0f,
-                    1.0f + alpha, -2.0f * cosW0, 1.0f - alpha);
-                break;
-            }
-            case 6: // Band Pass
-                coeffs = juce::dsp::IIR::Coefficients<float>::makeBandPass(sr, snap.freq, snap.q);
-                break;
-            default:
-                bandMag.fill(0.0f);
-                continue;
-            }
+        totalCurveDirty = false;
 
-            if (coeffs == nullptr)
-            {
-                bandMag.fill(0.0f);
-                continue;
-            }
+        // Total = sum of the active bands' dB curves (disabled bands are flat 0 dB)
+        juce::FloatVectorOperations::clear(cachedTotalMagnitude.data(), curveNumPoints);
 
-            // Use JUCE's batch magnitude computation (linear domain)
-            std::array<double, curveNumPoints> magnitudes{};
-            coeffs->getMagnitudeForFrequencyArray(curveFrequencies.data(), magnitudes.data(),
-                                                  static_cast<size_t>(curveNumPoints), sr);
+        for (int b = 0; b < activeBands; ++b)
+            juce::FloatVectorOperations::add(cachedTotalMagnitude.data(),
+                                              cachedBandMagnitudes[static_cast<size_t>(b)].data(), curveNumPoints);
+        return true;
+    }
 
-            for (int i = 0; i < curveNumPoints; ++i)
-            {
-                // Store per-band in dB (no premature floor clamping)
-                float magDB = static_cast<float>(juce::Decibels::gainToDecibels(magnitudes[static_cast<size_t>(i)]));
-                bandMag[static_cast<size_t>(i)] = magDB;
+    // Re-evaluate one band's magnitude response in dB
+    void rebuildBandCurve(int bandIndex)
+    {
+        const auto &snap = lastSnapshots[static_cast<size_t>(bandIndex)];
+        auto &bandMag = cachedBandMagnitudes[static_cast<size_t>(bandIndex)];
 
-                // Accumulate total in LINEAR domain to avoid dB clamping artefacts
-                totalLinearMagnitude[static_cast<size_t>(i)] *= magnitudes[static_cast<size_t>(i)];
-            }
+        juce::dsp::IIR::Coefficients<float>::Ptr coeffs;
+        if (snap.enabled && juce::isPositiveAndBelow(snap.type, 7))
+        {
+            float effectiveGain = snap.gain;
+            if (snap.dynamic)
+                effectiveGain -= snap.gr;
+
+            coeffs = DynamicEQBand::makeCoefficients(static_cast<BandParams::FilterType>(snap.type),
+                                                     curveSampleRate, snap.freq, snap.q, effectiveGain);
         }
 
-        // Convert accumulated linear total back to dB
-        for (int i = 0; i < curveNumPoints; ++i)
+        if (coeffs == nullptr)
         {
-            cachedTotalMagnitude[static_cast<size_t>(i)] =
-                static_cast<float>(juce::Decibels::gainToDecibels(totalLinearMagnitude[static_cast<size_t>(i)]));
+            bandMag.fill(0.0f);
+            return;
         }
+
+        curveResponse.getMagnitudeDB(*coeffs, bandMag.data());
     }
 
     //==============================================================================
@@ -391,7 +1226,7 @@ private:
         const float freqs[] = {50, 100, 200, 500, 1000, 2000, 5000, 10000};
         for (float freq : freqs)
         {
-            float x = freqToX(freq, bounds.getWidth(), minFreqHz, maxFreqHz);
+            float x = axis.freqToX(freq);
             g.drawVerticalLine(static_cast<int>(x), bounds.getY(), bounds.getBottom());
 
             g.setColour(juce::Colour(0x40FFFFFF));
@@ -410,7 +1245,7 @@ private:
         const float dbs[] = {-18, -12, -6, 0, 6, 12, 18};
         for (float db : dbs)
         {
-            float y = dbToY(db, bounds.getHeight(), minDB, maxDB);
+            float y = axis.dbToY(db);
             g.drawHorizontalLine(static_cast<int>(y), bounds.getX(), bounds.getRight());
 
             if (std::abs(db) > 0.1f)
@@ -424,45 +1259,42 @@ private:
         }
 
         // 0 dB center line (brighter)
-        float zeroY = dbToY(0.0f, bounds.getHeight(), minDB, maxDB);
+        float zeroY = axis.dbToY(0.0f);
         g.setColour(juce::Colour(0x30FFFFFF));
         g.drawHorizontalLine(static_cast<int>(zeroY), bounds.getX(), bounds.getRight());
     }
 
     //==============================================================================
     void drawSpectrum(juce::Graphics &g, juce::Rectangle<float> bounds,
-                      const std::array<float, SpectrumAnalyzer::fftSize / 2> &data,
+                      const std::vector<float> &data,
                       juce::Colour lineColour, juce::Colour fillColour)
     {
         const float width = bounds.getWidth();
         const float height = bounds.getHeight();
-        const float sampleRate = static_cast<float>(processor.getCurrentSampleRate());
-        if (sampleRate <= 0.0f)
+        if (processor.getCurrentSampleRate() <= 0.0)
             return;
-        const int fftHalfSize = SpectrumAnalyzer::fftSize / 2;
 
         juce::Path spectrumPath;
         bool pathStarted = false;
 
-        // Sample every 2 pixels for performance, then smooth via the path
-        const int step = 2;
-        for (int x = 0; x < static_cast<int>(width); x += step)
-        {
-            float freq = xToFreq(static_cast<float>(x), width, minFreqHz, maxFreqHz);
-            int binIndex = static_cast<int>(freq / (sampleRate / static_cast<float>(SpectrumAnalyzer::fftSize)));
-            binIndex = juce::jlimit(0, fftHalfSize - 1, binIndex);
+        // One value per display column, reduced over every bin the column covers
+        const int numColumns = axis.getNumColumns();
+        columnValues.resize(static_cast<size_t>(numColumns));
+        axis.mapSpectrum(data.data(), static_cast<int>(data.size()), columnValues.data(), spectrumReduction);
 
-            float magnitude = data[static_cast<size_t>(binIndex)];
-            float y = juce::jmap(magnitude, 0.0f, 1.0f, height, 0.0f);
+        for (int c = 0; c < numColumns; ++c)
+        {
+            const float x = axis.columnToX(c);
+            float y = juce::jmap(columnValues[static_cast<size_t>(c)], 0.0f, 1.0f, height, 0.0f);
 
             if (!pathStarted)
             {
-                spectrumPath.startNewSubPath(static_cast<float>(x), y);
+                spectrumPath.startNewSubPath(x, y);
                 pathStarted = true;
             }
             else
             {
-                spectrumPath.lineTo(static_cast<float>(x), y);
+                spectrumPath.lineTo(x, y);
             }
         }
 
@@ -471,17 +1303,20 @@ private:
             // Ensure path extends to right edge
             spectrumPath.lineTo(width, spectrumPath.getCurrentPosition().y);
 
-            // Create fill path
-            juce::Path fillPath(spectrumPath);
-            fillPath.lineTo(width, height);
-            fillPath.lineTo(0.0f, height);
-            fillPath.closeSubPath();
-
-            // Gradient fill
-            juce::ColourGradient gradient(fillColour.withAlpha(0.4f), 0.0f, 0.0f,
-                                          fillColour.withAlpha(0.0f), 0.0f, height, false);
-            g.setGradientFill(gradient);
-            g.fillPath(fillPath);
+            if (!fillColour.isTransparent())
+            {
+                // Create fill path
+                juce::Path fillPath(spectrumPath);
+                fillPath.lineTo(width, height);
+                fillPath.lineTo(0.0f, height);
+                fillPath.closeSubPath();
+
+                // Gradient fill
+                juce::ColourGradient gradient(fillColour.withAlpha(0.4f), 0.0f, 0.0f,
+                                              fillColour.withAlpha(0.0f), 0.0f, height, false);
+                g.setGradientFill(gradient);
+                g.fillPath(fillPath);
+            }
 
             // Stroke
             g.setColour(lineColour);
@@ -489,11 +1324,47 @@ private:
         }
     }
 
+    // Traces still at the previous resolution are skipped until the worker catches up
+    void drawTraces(juce::Graphics &g, juce::Rectangle<float> bounds)
+    {
+        const auto &traces = analysisJob.getPostTraces();
+        const auto numBins = smoothedPostSpectrum.size();
+
+        if (traces.isAverageEnabled() && averageTrace.size() == numBins)
+            drawSpectrum(g, bounds, averageTrace, juce::Colour(0xC06BCB77), juce::Colours::transparentBlack);
+        if (traces.isPeakHoldEnabled() && peakHoldTrace.size() == numBins)
+            drawSpectrum(g, bounds, peakHoldTrace, juce::Colour(0xB0FFD93D), juce::Colours::transparentBlack);
+        if (traces.isMaxHoldEnabled() && maxHoldTrace.size() == numBins)
+            drawSpectrum(g, bounds, maxHoldTrace, juce::Colour(0xB0FF6B6B), juce::Colours::transparentBlack);
+    }
+
+    // A marker per suggested resonance: a tick from the top edge, longer for stronger peaks
+    void drawResonances(juce::Graphics &g, juce::Rectangle<float> bounds)
+    {
+        g.setFont(juce::FontOptions(9.0f));
+        for (const auto &s : resonanceSuggestions)
+        {
+            const float x = axis.freqToX(s.frequency);
+            const float length = juce::jlimit(8.0f, 40.0f, 2.0f * s.prominenceDB);
+
+            g.setColour(juce::Colour(0xC0FF6B6B));
+            g.drawLine(x, bounds.getY(), x, bounds.getY() + length, 1.5f);
+
+            juce::Path marker;
+            marker.addTriangle(x - 4.0f, bounds.getY(), x + 4.0f, bounds.getY(), x, bounds.getY() + 6.0f);
+            g.fillPath(marker);
+
+            const auto label = s.frequency >= 1000.0f ? juce::String(s.frequency / 1000.0f, 1) + "k"
+                                                      : juce::String(juce::roundToInt(s.frequency));
+            g.drawText(label, juce::Rectangle<float>(x + 3.0f, bounds.getY() + length - 10.0f, 40.0f, 10.0f),
+                       juce::Justification::centredLeft);
+        }
+    }
+
     //==============================================================================
     void drawCachedEQCurve(juce::Graphics &g, juce::Rectangle<float> bounds)
     {
         const float width = bounds.getWidth();
-        const float height = bounds.getHeight();
 
         juce::Path curvePath;
 
@@ -501,7 +1372,7 @@ private:
         {
             float x = static_cast<float>(i) / static_cast<float>(curveNumPoints - 1) * width;
             float totalDB = juce::jlimit(minDB, maxDB, cachedTotalMagnitude[static_cast<size_t>(i)]);
-            float y = dbToY(totalDB, height, minDB, maxDB);
+            float y = axis.dbToY(totalDB);
 
             if (i == 0)
                 curvePath.startNewSubPath(x, y);
@@ -510,7 +1381,7 @@ private:
         }
 
         // Fill area between curve and 0dB line
-        float zeroY = dbToY(0.0f, height, minDB, maxDB);
+        float zeroY = axis.dbToY(0.0f);
         juce::Path fillPath(curvePath);
         fillPath.lineTo(width, zeroY);
         fillPath.lineTo(0.0f, zeroY);
@@ -532,7 +1403,6 @@ private:
             return;
 
         const float width = bounds.getWidth();
-        const float height = bounds.getHeight();
         auto &bandMag = cachedBandMagnitudes[static_cast<size_t>(bandIndex)];
 
         juce::Path bandPath;
@@ -541,7 +1411,7 @@ private:
         for (int i = 0; i < curveNumPoints; ++i)
         {
             float x = static_cast<float>(i) / static_cast<float>(curveNumPoints - 1) * width;
-            float y = dbToY(juce::jlimit(minDB, maxDB, bandMag[static_cast<size_t>(i)]), height, minDB, maxDB);
+            float y = axis.dbToY(juce::jlimit(minDB, maxDB, bandMag[static_cast<size_t>(i)]));
 
             if (i == 0)
                 bandPath.startNewSubPath(x, y);
@@ -550,7 +1420,7 @@ private:
         }
 
         // Fill area between band curve and 0dB
-        float zeroY = dbToY(0.0f, height, minDB, maxDB);
+        float zeroY = axis.dbToY(0.0f);
         juce::Path fillPath(bandPath);
         fillPath.lineTo(width, zeroY);
         fillPath.lineTo(0.0f, zeroY);
@@ -564,7 +1434,7 @@ private:
     }
 
     //==============================================================================
-    void drawNode(juce::Graphics &g, juce::Rectangle<float> bounds, int bandIndex)
+    void drawNode(juce::Graphics &g, int bandIndex)
     {
         auto &apvts = processor.getAPVTS();
         auto prefix = "band" + juce::String(bandIndex) + "_";
@@ -581,8 +1451,8 @@ private:
         const bool isGainless = (filterType >= 3);
         float displayGain = isGainless ? 0.0f : (gain - gainReduction);
 
-        float x = freqToX(freq, bounds.getWidth(), minFreqHz, maxFreqHz);
-        float y = dbToY(displayGain, bounds.getHeight(), minDB, maxDB);
+        float x = axis.freqToX(freq);
+        float y = axis.dbToY(displayGain);
 
         juce::Colour colour = getBandColour(bandIndex);
         bool isHovered = (hoveredBand == bandIndex);
@@ -596,21 +1466,27 @@ private:
         g.fillEllipse(x - currentGlowRadius, y - currentGlowRadius,
                       currentGlowRadius * 2.0f, currentGlowRadius * 2.0f);
 
-        // Gain reduction indicator line (when compression active, gain-based types only)
-        if (!isGainless && gainReduction > 0.1f)
+        // Gain reduction meter + trail (when compression active, gain-based types only).
+        // The meter shows the captured peak since the last frames, not just the latest block.
+        const auto &trail = grTrails[static_cast<size_t>(bandIndex)];
+        if (!isGainless)
+            drawGainReductionTrail(g, trail, x, gain, colour);
+
+        if (!isGainless && trail.meterPeak > grVisibleDB)
         {
-            float staticY = dbToY(gain, bounds.getHeight(), minDB, maxDB);
+            float staticY = axis.dbToY(gain);
+            float peakY   = axis.dbToY(gain - trail.meterPeak);
             g.setColour(colour.withAlpha(0.5f));
             juce::Path reductionLine;
             reductionLine.startNewSubPath(x, staticY);
-            reductionLine.lineTo(x, y);
+            reductionLine.lineTo(x, peakY);
             g.strokePath(reductionLine, juce::PathStrokeType(1.5f));
 
             // Draw small GR text
             g.setFont(juce::FontOptions(9.0f));
             g.setColour(colour.withAlpha(0.8f));
-            g.drawText("-" + juce::String(gainReduction, 1) + " dB",
-                       static_cast<int>(x) + 12, static_cast<int>((staticY + y) / 2.0f) - 6,
+            g.drawText("-" + juce::String(trail.meterPeak, 1) + " dB",
+                       static_cast<int>(x) + 12, static_cast<int>((staticY + peakY) / 2.0f) - 6,
                        50, 12, juce::Justification::left);
         }
 
@@ -632,12 +1508,36 @@ private:
                    juce::Justification::centred);
     }
 
+    // Scrolling GR trail: newest column at the node, older columns to the left
+    void drawGainReductionTrail(juce::Graphics &g, const GRTrail &trail, float nodeX, float staticGain, juce::Colour colour)
+    {
+        if (trail.numVisibleColumns == 0)
+            return;
+
+        const float step = grTrailWidth / static_cast<float>(grTrailColumns - 1);
+
+        juce::Path trailPath;
+        for (int k = 0; k < grTrailColumns; ++k)
+        {
+            // k = 0 is the oldest column
+            const float gr = trail.columns[static_cast<size_t>((trail.head + k) % grTrailColumns)];
+            const float tx = nodeX - grTrailWidth + static_cast<float>(k) * step;
+            const float ty = axis.dbToY(juce::jlimit(minDB, maxDB, staticGain - gr));
+
+            if (k == 0)
+                trailPath.startNewSubPath(tx, ty);
+            else
+                trailPath.lineTo(tx, ty);
+        }
+
+        g.setColour(colour.withAlpha(0.45f));
+        g.strokePath(trailPath, juce::PathStrokeType(1.2f));
+    }
+
     //==============================================================================
     int hitTestNode(juce::Point<float> pos)
     {
         auto &apvts = processor.getAPVTS();
-        float width  = static_cast<float>(getWidth());
-        float height = static_cast<float>(getHeight());
 
         for (int i = 0; i < processor.getActiveBandCount(); ++i)
         {
@@ -654,8 +1554,8 @@ private:
             // Gainless types always sit at 0 dB visually
             float displayGain = (type >= 3) ? 0.0f : (gain - gr);
 
-            float nx = freqToX(freq, width, minFreqHz, maxFreqHz);
-            float ny = dbToY(displayGain, height, minDB, maxDB);
+            float nx = axis.freqToX(freq);
+            float ny = axis.dbToY(displayGain);
 
             float dist = pos.getDistanceFrom({nx, ny});
             if (dist <= glowRadius)
@@ -677,7 +1577,7 @@ private:
         // absolute mouse Y maps to (accounts for GR offset), so the node never jumps at drag start.
         float startGain  = apvts.getRawParameterValue(prefix + "gain")->load();
         float clampedY   = juce::jlimit(0.0f, height, mousePos.y);
-        dragGainBias     = startGain - yToDb(clampedY, height, minDB, maxDB);
+        dragGainBias     = startGain - axis.yToDb(clampedY);
     }
 
     void performDrag(int bandIndex, juce::Point<float> pos)
@@ -688,9 +1588,9 @@ private:
         float height = static_cast<float>(getHeight());
 
         // ---- Frequency: delta X in log domain ----
-        float startX  = freqToX(dragStartFreq, width, minFreqHz, maxFreqHz);
+        float startX  = axis.freqToX(dragStartFreq);
         float targetX = juce::jlimit(0.0f, width, startX + (pos.x - dragStartMouseX));
-        float freq    = juce::jlimit(minFreqHz, maxFreqHz, xToFreq(targetX, width, minFreqHz, maxFreqHz));
+        float freq    = juce::jlimit(minFreqHz, maxFreqHz, axis.xToFreq(targetX));
 
         auto *freqParam = apvts.getParameter(prefix + "freq");
         if (freqParam != nullptr)
@@ -701,7 +1601,7 @@ private:
         if (filterType < 3)
         {
             float clampedY = juce::jlimit(0.0f, height, pos.y);
-            float gain     = juce::jlimit(minDB, maxDB, yToDb(clampedY, height, minDB, maxDB) + dragGainBias);
+            float gain     = juce::jlimit(minDB, maxDB, axis.yToDb(clampedY) + dragGainBias);
 
             auto *gainParam = apvts.getParameter(prefix + "gain");
             if (gainParam != nullptr)
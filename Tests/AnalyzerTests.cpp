@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    AnalyzerTests.cpp
+    Spectrum analyzer: packed pre / post analysis against separate transforms,
+    and the bundled FFT backend against JUCE's
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "DSP/FFTBackend.h"
+#include "DSPFixture.h"
+
+//==============================================================================
+// One packed complex FFT must give both channels the spectra of two separate real
+// transforms. The difference is float rounding of the shared transform; leakage of
+// the loud pre channel into the quiet post one would exceed the tolerance.
+class PackedAnalysisTest : public juce::UnitTest
+{
+public:
+    PackedAnalysisTest() : juce::UnitTest ("Packed pre / post analysis", "DynamicEQ") {}
+
+    // Relative to the strongest bin of the frame
+    static constexpr float tolerance = 1.0e-5f;   // -100 dB
+
+    void runTest() override
+    {
+        using Window = SpectrumAnalyzer::Window;
+
+        for (int order = SpectrumAnalyzer::minFFTOrder; order <= SpectrumAnalyzer::maxFFTOrder; ++order)
+        {
+            for (auto window : { Window::hann, Window::blackmanHarris, Window::flatTop, Window::rectangular })
+            {
+                SpectrumAnalyzer::Config config;
+                config.fftOrder = order;
+                config.window = window;
+
+                beginTest (juce::String (config.getFFTSize()) + " points, window " + juce::String (static_cast<int> (window)));
+                const float difference = compare (config);
+                expectLessOrEqual (difference, tolerance,
+                                   juce::String (juce::Decibels::gainToDecibels (difference, -200.0f), 1) + " dB re peak");
+            }
+        }
+    }
+
+private:
+    static float compare (const SpectrumAnalyzer::Config& config)
+    {
+        juce::AudioBuffer<float> input (2, config.getFFTSize());
+        DSPFixture::fillAnalyzerPairInput (input);
+
+        auto separate = std::make_unique<DSPFixture::AnalyzerPair>();
+        auto packed   = std::make_unique<DSPFixture::AnalyzerPair>();
+
+        for (auto* pair : { separate.get(), packed.get() })
+        {
+            pair->setConfig (config);
+            pair->push (input);
+        }
+
+        separate->analyseSeparately();
+        packed->analysePacked();
+        return separate->getRelativeDifference (*packed, config.getNumBins());
+    }
+};
+
+static PackedAnalysisTest packedAnalysisTest;
+
+//==============================================================================
+// The bundled FFT's real forward transform must agree with juce::dsp::FFT bin for
+// bin, from 512 to 32768 points, so switching backends leaves the display alone
+class FFTBackendTest : public juce::UnitTest
+{
+public:
+    FFTBackendTest() : juce::UnitTest ("FFT backends", "DynamicEQ") {}
+
+    // Relative to the strongest bin
+    static constexpr float tolerance = 1.0e-5f;
+
+    void runTest() override
+    {
+        using Engine = FFTBackend::Engine;
+
+        for (int order = 9; order <= 15; ++order)
+        {
+            const int n = 1 << order;
+            beginTest (juce::String (n) + " points");
+
+            juce::AudioBuffer<float> input (1, n);
+            DSPFixture::fillNoise (input, 0.5f);
+
+            std::vector<float> reference (static_cast<size_t> (2 * n)), bundled (static_cast<size_t> (2 * n));
+            std::copy (input.getReadPointer (0), input.getReadPointer (0) + n, reference.begin());
+            std::copy (input.getReadPointer (0), input.getReadPointer (0) + n, bundled.begin());
+
+            FFTBackend::create (order, Engine::juce)->performRealOnlyForwardTransform (reference.data());
+            FFTBackend::create (order, Engine::bundled)->performRealOnlyForwardTransform (bundled.data());
+
+            float peak = 0.0f, maxError = 0.0f;
+            for (size_t i = 0; i <= static_cast<size_t> (n + 1); ++i)
+            {
+                peak = juce::jmax (peak, std::abs (reference[i]));
+                maxError = juce::jmax (maxError, std::abs (bundled[i] - reference[i]));
+            }
+
+            expectLessOrEqual (maxError / juce::jmax (peak, std::numeric_limits<float>::min()), tolerance);
+        }
+    }
+};
+
+static FFTBackendTest fftBackendTest;
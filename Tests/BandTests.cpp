@@ -0,0 +1,176 @@
+/*
+  ==============================================================================
+
+    BandTests.cpp
+    Band filters: in-place coefficient design, specialised kernels and the
+    closed-form display curve, each against the JUCE path it replaced
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "DSP/BiquadResponse.h"
+#include "DSPFixture.h"
+
+//==============================================================================
+// DynamicEQBand::designCoefficients is the allocation-free design the ramp runs on the
+// audio thread. It must give JUCE's IIR::Coefficients designs up to float rounding,
+// across the whole frequency range, and keep the exact relations its type's
+// specialised kernel relies on.
+class CoefficientDesignTest : public juce::UnitTest
+{
+public:
+    CoefficientDesignTest() : juce::UnitTest ("Band coefficient design", "DynamicEQ") {}
+
+    // Per coefficient, relative to the larger of 1 and the JUCE value
+    static constexpr float tolerance = 1.0e-5f;
+
+    void runTest() override
+    {
+        for (double sampleRate : { 44100.0, 48000.0, 96000.0 })
+        {
+            for (const auto& s : DSPFixture::getFilterSettings())
+            {
+                beginTest (juce::String (s.name) + " @ " + juce::String (sampleRate, 0) + " Hz");
+
+                for (float freq : { 20.0f, s.freq, 18000.0f })
+                {
+                    const auto designed = DynamicEQBand::designCoefficients (s.type, sampleRate, freq, s.q, s.gainDB);
+                    const float designedCoeffs[] = { designed.b0, designed.b1, designed.b2, designed.a1, designed.a2 };
+                    const auto reference = makeJuceCoefficients (s.type, sampleRate, freq, s.q, s.gainDB);
+
+                    float maxError = 0.0f;
+                    for (int i = 0; i < 5; ++i)
+                    {
+                        const float ref = reference->coefficients[i];
+                        maxError = juce::jmax (maxError, std::abs (designedCoeffs[i] - ref) / juce::jmax (1.0f, std::abs (ref)));
+                    }
+
+                    expectLessOrEqual (maxError, tolerance, juce::String (freq, 0) + " Hz");
+                    expect (BiquadKernels::hasStructure (designed, DynamicEQBand::getKernelStructure (s.type)),
+                            juce::String (freq, 0) + " Hz breaks the kernel structure");
+                }
+            }
+        }
+    }
+
+private:
+    using Coefficients = juce::dsp::IIR::Coefficients<float>;
+
+    static Coefficients::Ptr makeJuceCoefficients (BandParams::FilterType type, double sampleRate,
+                                                   float freq, float q, float gainDB)
+    {
+        const float gain = juce::Decibels::decibelsToGain (gainDB);
+
+        switch (type)
+        {
+            case BandParams::FilterType::LowShelf:  return Coefficients::makeLowShelf (sampleRate, freq, q, gain);
+            case BandParams::FilterType::HighShelf: return Coefficients::makeHighShelf (sampleRate, freq, q, gain);
+            case BandParams::FilterType::LowCut:    return Coefficients::makeHighPass (sampleRate, freq, q);
+            case BandParams::FilterType::HighCut:   return Coefficients::makeLowPass (sampleRate, freq, q);
+            case BandParams::FilterType::Notch:     return Coefficients::makeNotch (sampleRate, freq, q);
+            case BandParams::FilterType::BandPass:  return Coefficients::makeBandPass (sampleRate, freq, q);
+            case BandParams::FilterType::Peak:
+            default:                                return Coefficients::makePeakFilter (sampleRate, freq, q, gain);
+        }
+    }
+};
+
+static CoefficientDesignTest coefficientDesignTest;
+
+//==============================================================================
+// Each type's specialised kernel against juce::dsp::IIR::Filter (the previous band
+// path) on the same coefficients and stereo noise. They differ only by the
+// rearranged arithmetic, so the error stays at float rounding of the signal.
+class BiquadKernelTest : public juce::UnitTest
+{
+public:
+    BiquadKernelTest() : juce::UnitTest ("Specialised biquad kernels", "DynamicEQ") {}
+
+    // Absolute, on noise peaking at -12 dBFS
+    static constexpr float tolerance = 1.0e-4f;
+
+    void runTest() override
+    {
+        constexpr int blockSize = DSPFixture::blockSize, numChannels = DSPFixture::numChannels;
+        const double sampleRate = 48000.0;
+
+        juce::AudioBuffer<float> work (numChannels, blockSize), reference (numChannels, blockSize);
+        DSPFixture::fillNoise (reference, juce::Decibels::decibelsToGain (-12.0f));
+
+        for (const auto& s : DSPFixture::getFilterSettings())
+        {
+            beginTest (s.name);
+
+            work.makeCopyOf (reference, true);
+
+            const auto coeffs = DynamicEQBand::designCoefficients (s.type, sampleRate, s.freq, s.q, s.gainDB);
+            const auto kernel = BiquadKernels::get (DynamicEQBand::getKernelStructure (s.type));
+            const auto juceCoeffs = DynamicEQBand::makeCoefficients (s.type, sampleRate, s.freq, s.q, s.gainDB);
+
+            float maxError = 0.0f;
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                BiquadKernels::State state {};
+                kernel (coeffs, state, work.getWritePointer (ch), blockSize);
+
+                juce::dsp::IIR::Filter<float> filter (juceCoeffs);
+                const auto* ref = reference.getReadPointer (ch);
+                for (int i = 0; i < blockSize; ++i)
+                    maxError = juce::jmax (maxError, std::abs (work.getSample (ch, i) - filter.processSample (ref[i])));
+            }
+
+            expectLessOrEqual (maxError, tolerance);
+        }
+    }
+};
+
+static BiquadKernelTest biquadKernelTest;
+
+//==============================================================================
+// BiquadResponse's closed-form magnitude against JUCE's complex evaluation over the
+// display grid. Near the bottom of a notch both lose precision, so the comparison
+// covers the curve above -40 dB, which is what the display resolves.
+class BiquadResponseTest : public juce::UnitTest
+{
+public:
+    BiquadResponseTest() : juce::UnitTest ("Closed-form magnitude curve", "DynamicEQ") {}
+
+    static constexpr float toleranceDB = 0.01f;
+    static constexpr float floorDB = -40.0f;
+
+    void runTest() override
+    {
+        static constexpr int numPoints = 1024;
+        const double sampleRate = 48000.0;
+
+        std::vector<double> freqs (numPoints), linear (numPoints);
+        std::vector<float> curve (numPoints);
+        for (int i = 0; i < numPoints; ++i)
+            freqs[static_cast<size_t> (i)] = 20.0 * std::pow (1000.0, i / static_cast<double> (numPoints - 1));
+
+        BiquadResponse response;
+        response.prepare (freqs.data(), numPoints, sampleRate);
+
+        for (const auto& s : DSPFixture::getFilterSettings())
+        {
+            beginTest (s.name);
+
+            const auto c = DynamicEQBand::makeCoefficients (s.type, sampleRate, s.freq, s.q, s.gainDB);
+            c->getMagnitudeForFrequencyArray (freqs.data(), linear.data(), static_cast<size_t> (numPoints), sampleRate);
+            response.getMagnitudeDB (*c, curve.data());
+
+            float maxErrorDB = 0.0f;
+            for (size_t i = 0; i < linear.size(); ++i)
+            {
+                const auto ref = static_cast<float> (juce::Decibels::gainToDecibels (linear[i]));
+                if (ref > floorDB)
+                    maxErrorDB = juce::jmax (maxErrorDB, std::abs (ref - curve[i]));
+            }
+
+            expectLessOrEqual (maxErrorDB, toleranceDB);
+        }
+    }
+};
+
+static BiquadResponseTest biquadResponseTest;
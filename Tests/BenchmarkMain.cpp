@@ -0,0 +1,22 @@
+/*
+  ==============================================================================
+
+    BenchmarkMain.cpp
+    Console runner for the DSP micro-benchmarks
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "DSPBenchmark.h"
+
+// DynamicEQBenchmark [sampleRate]   (default 48000 Hz)
+int main (int argc, char* argv[])
+{
+    const double requested = argc > 1 ? juce::String (argv[1]).getDoubleValue() : 0.0;
+    const double sampleRate = requested > 0.0 ? requested : 48000.0;
+
+    std::cout << DSPBenchmark::runAll (sampleRate) << std::flush;
+    return 0;
+}
@@ -0,0 +1,569 @@
+/*
+  ==============================================================================
+
+    DSPBenchmark.h
+    Offline micro-benchmarks for the DSP and display building blocks
+    (DynamicEQBenchmark console app, not part of the plugin)
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSP/BiquadResponse.h"
+#include "DSP/FFTBackend.h"
+#include "DSP/MatchEQ.h"
+#include "DSP/SpectralDynamics.h"
+#include "UI/SpectrumAxis.h"
+#include "DSPFixture.h"
+
+//==============================================================================
+// Runs private instances of the DSP classes on synthetic audio and reports
+// ns/sample. Takes several seconds per section, so it lives in its own console
+// app rather than in the plugin. Correctness is asserted by the unit tests in
+// DynamicEQTests; this only measures.
+//==============================================================================
+struct DSPBenchmark
+{
+    static constexpr int blockSize   = DSPFixture::blockSize;
+    static constexpr int numChannels = DSPFixture::numChannels;
+    static constexpr int numBlocks   = 400;   // ~4.3 s of audio at 48 kHz per measurement
+
+    // Average ns per processed sample of `process`, after one warm-up call
+    template <typename Fn>
+    static double measureNsPerSample (Fn&& process, int samplesPerCall, int numCalls)
+    {
+        process();
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < numCalls; ++i)
+            process();
+        const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+        return juce::Time::highResolutionTicksToSeconds (elapsed) * 1.0e9
+             / (static_cast<double> (samplesPerCall) * static_cast<double> (numCalls));
+    }
+
+    static juce::String formatLine (const juce::String& name, double nsPerUnit, const juce::String& unit = "ns/sample")
+    {
+        return "  " + name.paddedRight (' ', 54) + " " + juce::String (nsPerUnit, 2) + " " + unit + juce::newLine;
+    }
+
+    //==============================================================================
+    // 8-band cascade with the plugin's default layout, with and without identity elision.
+    // Input is noise below the default -20 dB threshold, so the bands get no reduction.
+    static juce::String runBandCascade (double sampleRate)
+    {
+        static constexpr int numBands = DSPFixture::numDefaultBands;
+
+        struct Template { const char* name; int numBoosted; };
+        const Template templates[] = {
+            { "Default template (all bands 0 dB)", 0 },
+            { "2 of 8 bands boosted",              2 },
+            { "All 8 bands boosted",               8 },
+        };
+
+        juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32> (blockSize),
+                                      static_cast<juce::uint32> (numChannels) };
+
+        juce::AudioBuffer<float> source (numChannels, blockSize), work (numChannels, blockSize);
+        DSPFixture::fillNoise (source, juce::Decibels::decibelsToGain (-24.0f));
+
+        juce::String r;
+        r << "Band cascade (8 bands, noise @ -24 dBFS)" << juce::newLine;
+        for (const auto& t : templates)
+        {
+            double results[2] {};
+
+            for (int elide = 0; elide < 2; ++elide)
+            {
+                // Fresh bands per run so no parameter ramp carries over between measurements
+                auto bands = std::make_unique<std::array<DynamicEQBand, numBands>>();
+
+                for (int b = 0; b < numBands; ++b)
+                {
+                    auto p = DSPFixture::getDefaultBand (b);
+                    p.gain = (b < t.numBoosted) ? 3.0f : 0.0f;
+
+                    auto& band = (*bands)[static_cast<size_t> (b)];
+                    band.prepare (spec);
+                    band.setIdentityElisionEnabled (elide == 1);
+                    band.updateParams (p);
+                }
+
+                results[elide] = measureNsPerSample ([&]
+                {
+                    work.makeCopyOf (source, true);
+                    for (auto& band : *bands)
+                        band.process (work, 0.0f);
+                }, blockSize, numBlocks);
+            }
+
+            r << formatLine (juce::String (t.name) + " / full cascade", results[0])
+              << formatLine (juce::String (t.name) + " / elided",       results[1]);
+        }
+
+        return r;
+    }
+
+    //==============================================================================
+    // Detectors and gain computers of 32 bands, updated per sample (the finest control
+    // rate) and per block: the DetectorBank against the scalar per-band formulation it
+    // replaced. Times are per band update.
+    static juce::String runDetectorBank (double sampleRate)
+    {
+        static constexpr int numBands = DSPFixture::numDetectorBands;
+
+        auto detectors = std::make_unique<DSPFixture::DetectorPair>();
+        detectors->prepare (sampleRate);
+
+        const auto levels = DSPFixture::makeDetectorLevels (static_cast<size_t> (blockSize) * static_cast<size_t> (numBlocks));
+        std::array<float, numBands> reductions {};
+        float sink = 0.0f;
+        size_t position = 0;
+        const auto nextLevel = [&]
+        {
+            position = (position + 1) % levels.size();
+            return levels[position];
+        };
+
+        juce::String r;
+        r << "Detector bank (32 bands, per band update)" << juce::newLine;
+
+        for (int step : { 1, blockSize })
+        {
+            const int updatesPerCall = blockSize / step;
+            const auto rateName = juce::String (step == 1 ? "per sample" : "per block");
+
+            position = 0;
+            const double scalarNs = measureNsPerSample ([&]
+            {
+                for (int u = 0; u < updatesPerCall; ++u)
+                {
+                    const float level = nextLevel();
+                    for (auto& s : detectors->scalar)
+                        sink += s.process (level, step);
+                }
+            }, updatesPerCall * numBands, numBlocks);
+
+            position = 0;
+            const double bankNs = measureNsPerSample ([&]
+            {
+                for (int u = 0; u < updatesPerCall; ++u)
+                {
+                    detectors->bank.process (nextLevel(), step, numBands, reductions.data());
+                    sink += reductions[0];
+                }
+            }, updatesPerCall * numBands, numBlocks);
+
+            r << formatLine ("Scalar per band / " + rateName, scalarNs, "ns/update")
+              << formatLine ("DetectorBank / " + rateName, bankNs, "ns/update");
+        }
+
+        volatile float keep = sink;
+        juce::ignoreUnused (keep);
+        return r;
+    }
+
+    //==============================================================================
+    // One biquad per filter type on stereo noise: juce::dsp::IIR::Filter (the previous
+    // band path), the general BiquadKernels kernel, and the type's specialised kernel
+    static juce::String runBiquadKernels (double sampleRate)
+    {
+        juce::AudioBuffer<float> source (numChannels, blockSize), work (numChannels, blockSize);
+        DSPFixture::fillNoise (source, juce::Decibels::decibelsToGain (-12.0f));
+
+        juce::String r;
+        r << "Biquad kernels (IIR::Filter / general / specialised)" << juce::newLine;
+
+        for (const auto& s : DSPFixture::getFilterSettings())
+        {
+            auto juceCoeffs = DynamicEQBand::makeCoefficients (s.type, sampleRate, s.freq, s.q, s.gainDB);
+            const auto coeffs = DynamicEQBand::designCoefficients (s.type, sampleRate, s.freq, s.q, s.gainDB);
+            const auto general = BiquadKernels::get (BiquadKernels::Structure::general);
+            const auto specialised = BiquadKernels::get (DynamicEQBand::getKernelStructure (s.type));
+
+            std::array<juce::dsp::IIR::Filter<float>, numChannels> filters;
+            for (auto& f : filters)
+                f.coefficients = juceCoeffs;
+
+            std::array<BiquadKernels::State, numChannels> states {};
+            auto runKernel = [&] (BiquadKernels::Kernel kernel)
+            {
+                work.makeCopyOf (source, true);
+                for (int ch = 0; ch < numChannels; ++ch)
+                    kernel (coeffs, states[static_cast<size_t> (ch)], work.getWritePointer (ch), blockSize);
+            };
+
+            const double juceNs = measureNsPerSample ([&]
+            {
+                work.makeCopyOf (source, true);
+                juce::dsp::AudioBlock<float> block (work);
+                for (size_t ch = 0; ch < static_cast<size_t> (numChannels); ++ch)
+                {
+                    auto channel = block.getSingleChannelBlock (ch);
+                    filters[ch].process (juce::dsp::ProcessContextReplacing<float> (channel));
+                }
+            }, blockSize, numBlocks);
+
+            const double generalNs = measureNsPerSample ([&] { runKernel (general); }, blockSize, numBlocks);
+            const double specialisedNs = measureNsPerSample ([&] { runKernel (specialised); }, blockSize, numBlocks);
+
+            r << "  " << juce::String (s.name).paddedRight (' ', 14)
+              << juce::String (juceNs, 2) << " / " << juce::String (generalNs, 2) << " / "
+              << juce::String (specialisedNs, 2) << " ns/sample" << juce::newLine;
+        }
+
+        return r;
+    }
+
+    //==============================================================================
+    // Display-curve evaluation: JUCE's complex evaluation + gainToDecibels vs the
+    // closed-form BiquadResponse, over a 1024-point log grid
+    static juce::String runCurveEvaluation (double sampleRate)
+    {
+        static constexpr int numPoints = 1024;
+        static constexpr int numCalls  = 2000;
+
+        std::vector<double> freqs (numPoints);
+        for (int i = 0; i < numPoints; ++i)
+            freqs[static_cast<size_t> (i)] = 20.0 * std::pow (1000.0, i / static_cast<double> (numPoints - 1));
+
+        BiquadResponse response;
+        response.prepare (freqs.data(), numPoints, sampleRate);
+
+        juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> filters;
+        filters.add (DynamicEQBand::makeCoefficients (BandParams::FilterType::Peak,      sampleRate, 1000.0f, 4.0f, 12.0f));
+        filters.add (DynamicEQBand::makeCoefficients (BandParams::FilterType::LowShelf,  sampleRate, 80.0f, 0.7f, -6.0f));
+        filters.add (DynamicEQBand::makeCoefficients (BandParams::FilterType::LowCut,    sampleRate, 30.0f, 0.707f, 0.0f));
+        filters.add (DynamicEQBand::makeCoefficients (BandParams::FilterType::Notch,     sampleRate, 3000.0f, 8.0f, 0.0f));
+
+        std::vector<double> linear (numPoints);
+        std::vector<float> reference (numPoints), fast (numPoints);
+        int next = 0;
+
+        const double generic = measureNsPerSample ([&]
+        {
+            auto& c = *filters[next++ % filters.size()];
+            c.getMagnitudeForFrequencyArray (freqs.data(), linear.data(), static_cast<size_t> (numPoints), sampleRate);
+            for (size_t i = 0; i < linear.size(); ++i)
+                reference[i] = static_cast<float> (juce::Decibels::gainToDecibels (linear[i]));
+        }, numPoints, numCalls);
+
+        const double closedForm = measureNsPerSample ([&]
+        {
+            response.getMagnitudeDB (*filters[next++ % filters.size()], fast.data());
+        }, numPoints, numCalls);
+
+        juce::String r;
+        r << "Biquad magnitude curve (1024 points, 20 Hz - 20 kHz)" << juce::newLine
+          << formatLine ("IIR::Coefficients + gainToDecibels", generic, "ns/point")
+          << formatLine ("BiquadResponse (closed form)",       closedForm, "ns/point");
+        return r;
+    }
+
+    //==============================================================================
+    // Per-frame axis mapping work of the spectrum view at 1200 x 500: both spectra
+    // mapped to display columns, plus grid lines and node placement + hit testing.
+    // The direct path is the old single-bin-per-column lookup with std::pow per column.
+    static juce::String runAxisMapping (double sampleRate)
+    {
+        static constexpr int width = 1200, height = 500, numFrames = 2000;
+        static constexpr int fftSize = 4096, numBins = fftSize / 2;
+        const float gridFreqs[] = { 50, 100, 200, 500, 1000, 2000, 5000, 10000 };
+
+        SpectrumAxis axis;
+        axis.setSize (width, height);
+        axis.setSampleRate (sampleRate, fftSize);
+
+        std::vector<float> bins (numBins), columns (static_cast<size_t> (axis.getNumColumns()));
+        juce::Random random (0x5eed);
+        for (auto& b : bins)
+            b = random.nextFloat();
+
+        const auto w = static_cast<float> (width);
+        const auto binWidth = static_cast<float> (sampleRate / fftSize);
+        float sink = 0.0f;
+
+        const double direct = measureNsPerSample ([&]
+        {
+            for (int pass = 0; pass < 2; ++pass)
+                for (int x = 0; x < width; x += axis.getPixelsPerColumn())
+                {
+                    const auto bin = static_cast<int> (SpectrumAxis::exactXToFreq (static_cast<float> (x), w) / binWidth);
+                    sink += bins[static_cast<size_t> (juce::jlimit (0, numBins - 1, bin))];
+                }
+
+            for (int pass = 0; pass < 3; ++pass)
+                for (auto f : gridFreqs)
+                    sink += SpectrumAxis::exactFreqToX (f, w);
+        }, 1, numFrames);
+
+        auto tables = [&] (SpectrumAxis::Reduction reduction)
+        {
+            return measureNsPerSample ([&]
+            {
+                for (int pass = 0; pass < 2; ++pass)
+                {
+                    axis.mapSpectrum (bins.data(), numBins, columns.data(), reduction);
+                    sink += columns.back();
+                }
+
+                for (int pass = 0; pass < 3; ++pass)
+                    for (auto f : gridFreqs)
+                        sink += axis.freqToX (f);
+            }, 1, numFrames);
+        };
+
+        const double peak    = tables (SpectrumAxis::Reduction::Peak);
+        const double average = tables (SpectrumAxis::Reduction::PowerAverage);
+
+        // Keep the loops from being optimised away
+        volatile float keep = sink;
+        juce::ignoreUnused (keep);
+
+        juce::String r;
+        r << "Spectrum view axis mapping (1200 x 500, per frame)" << juce::newLine
+          << formatLine ("Single bin, std::log / std::pow per call", direct,  "ns/frame")
+          << formatLine ("SpectrumAxis tables, peak",                peak,    "ns/frame")
+          << formatLine ("SpectrumAxis tables, power average",       average, "ns/frame");
+        return r;
+    }
+
+    //==============================================================================
+    // One analyzer frame (window + FFT + dB mapping) per call, with and without
+    // fractional-octave smoothing at the default resolution, then without smoothing
+    // across every selectable FFT size. Smoothing cost should not depend on bandwidth.
+    static juce::String runAnalyzer()
+    {
+        static constexpr int numFrames = 200;
+        using Smoothing = SpectrumAnalyzer::Smoothing;
+
+        auto analyzer = std::make_unique<SpectrumAnalyzer>();
+        std::vector<float> magnitudes;
+        juce::AudioBuffer<float> noise;
+
+        auto measure = [&] (SpectrumAnalyzer::Config config, Smoothing smoothing)
+        {
+            noise.setSize (1, config.getHopSize());
+            DSPFixture::fillNoise (noise, 0.5f);
+
+            analyzer->setConfig (config);
+            analyzer->setSmoothing (smoothing);
+            return measureNsPerSample ([&]
+            {
+                analyzer->pushSamples (noise.getReadPointer (0), noise.getNumSamples());
+                analyzer->processFFT (magnitudes);
+            }, 1, numFrames) * 1.0e-3;
+        };
+
+        const SpectrumAnalyzer::Config defaults;
+
+        juce::String r;
+        r << "Analyzer frame (" << defaults.getFFTSize() << "-point FFT, Hann)" << juce::newLine
+          << formatLine ("No smoothing",     measure (defaults, Smoothing::off),          "us/frame")
+          << formatLine ("1/3 octave",       measure (defaults, Smoothing::third),        "us/frame")
+          << formatLine ("1/24 octave",      measure (defaults, Smoothing::twentyFourth), "us/frame");
+
+        r << "Analyzer resolution (no smoothing)" << juce::newLine;
+        for (int order = SpectrumAnalyzer::minFFTOrder; order <= SpectrumAnalyzer::maxFFTOrder; ++order)
+        {
+            auto config = defaults;
+            config.fftOrder = order;
+            r << formatLine (juce::String (config.getFFTSize()) + "-point FFT", measure (config, Smoothing::off), "us/frame");
+        }
+
+        return r;
+    }
+
+    //==============================================================================
+    // Pre- and post-EQ analysis as two real transforms and as one packed complex FFT,
+    // timed per frame, plus how far packing moves the magnitudes (asserted by
+    // PackedAnalysisTest; shown here for convenience)
+    static juce::String runAnalyzerPair()
+    {
+        static constexpr int numFrames = 200;
+        const SpectrumAnalyzer::Config config;
+
+        juce::AudioBuffer<float> input (2, config.getHopSize());
+        DSPFixture::fillAnalyzerPairInput (input);
+
+        auto separate = std::make_unique<DSPFixture::AnalyzerPair>();
+        auto packed   = std::make_unique<DSPFixture::AnalyzerPair>();
+
+        const double separateUs = measureNsPerSample ([&]
+        {
+            separate->push (input);
+            separate->analyseSeparately();
+        }, 1, numFrames) * 1.0e-3;
+
+        const double packedUs = measureNsPerSample ([&]
+        {
+            packed->push (input);
+            packed->analysePacked();
+        }, 1, numFrames) * 1.0e-3;
+
+        // Both pairs have now seen identical input, so their last frames must agree
+        const float difference = separate->getRelativeDifference (*packed, config.getNumBins());
+
+        juce::String r;
+        r << "Pre + post analysis (" << config.getFFTSize() << "-point FFT)" << juce::newLine
+          << formatLine ("Two real transforms",     separateUs, "us/frame")
+          << formatLine ("One packed complex FFT",  packedUs,   "us/frame")
+          << "  Max difference: " << juce::String (juce::Decibels::gainToDecibels (difference, -200.0f), 1)
+          << " dB re peak" << juce::newLine;
+        return r;
+    }
+
+    //==============================================================================
+    // Real forward transforms from 512 to 32768 points on every FFT backend
+    static juce::String runFFTBackends()
+    {
+        using Engine = FFTBackend::Engine;
+
+        juce::String r;
+        r << "FFT backends (real forward transform)" << juce::newLine;
+
+        for (int order = 9; order <= 15; ++order)
+        {
+            const int n = 1 << order;
+            const int numCalls = juce::jmax (20, (1 << 22) / n);   // ~4M points per measurement
+
+            juce::AudioBuffer<float> input (1, n);
+            DSPFixture::fillNoise (input, 0.5f);
+
+            std::vector<float> work (static_cast<size_t> (2 * n));
+
+            for (auto engine : { Engine::juce, Engine::bundled })
+            {
+                auto fft = FFTBackend::create (order, engine);
+
+                const double ns = measureNsPerSample ([&]
+                {
+                    std::copy (input.getReadPointer (0), input.getReadPointer (0) + n, work.begin());
+                    fft->performRealOnlyForwardTransform (work.data());
+                }, n, numCalls);
+
+                r << formatLine (juce::String (n) + " points, " + fft->getName(), ns * n * 1.0e-3, "us/transform");
+            }
+        }
+
+        return r;
+    }
+
+    //==============================================================================
+    // Match-EQ fit of 8, 16 and 32 bands to a known 5-band curve on a tilted, rippled
+    // source. One fit per size: the time is the fitter's own measurement of fit().
+    static juce::String runMatchFit (double sampleRate)
+    {
+        using Type = BandParams::FilterType;
+        struct Band { Type type; float freq, q, gainDB; };
+        const Band curve[] = { { Type::LowShelf, 90.0f, 0.7f, 4.0f },   { Type::Peak, 300.0f, 2.0f, -5.0f },
+                               { Type::Peak, 2500.0f, 1.2f, 3.0f },     { Type::Peak, 6000.0f, 4.0f, -6.0f },
+                               { Type::HighShelf, 10000.0f, 0.7f, -3.0f } };
+
+        std::array<double, MatchSpectrum::numPoints> freqs;
+        for (int i = 0; i < MatchSpectrum::numPoints; ++i)
+            freqs[static_cast<size_t> (i)] = MatchSpectrum::getFrequency (i);
+
+        BiquadResponse response;
+        response.prepare (freqs.data(), MatchSpectrum::numPoints, sampleRate);
+
+        MatchSpectrum source, reference;
+        std::vector<float> bandDB (static_cast<size_t> (MatchSpectrum::numPoints));
+        for (size_t i = 0; i < source.db.size(); ++i)
+        {
+            source.db[i] = -20.0f - 0.25f * static_cast<float> (i) + 2.0f * std::sin (0.7f * static_cast<float> (i));
+            reference.db[i] = source.db[i] + 6.0f;
+            source.weight[i] = reference.weight[i] = freqs[i] < 0.45 * sampleRate ? 1.0f : 0.0f;
+        }
+
+        for (const auto& b : curve)
+        {
+            response.getMagnitudeDB (*DynamicEQBand::makeCoefficients (b.type, sampleRate, b.freq, b.q, b.gainDB), bandDB.data());
+            for (size_t i = 0; i < reference.db.size(); ++i)
+                reference.db[i] += bandDB[i];
+        }
+
+        juce::String r;
+        r << "Match EQ fit (" << MatchSpectrum::numPoints << " points, 4 band layouts, Levenberg-Marquardt)" << juce::newLine;
+
+        for (int numBands : { 8, 16, 32 })
+        {
+            MatchEQFitter fitter (sampleRate);
+            const auto result = fitter.fit (reference, source, numBands);
+
+            r << formatLine (juce::String (numBands) + " bands, full fit", result.milliseconds, "ms")
+              << "  " << result.iterations << " iterations, residual " << juce::String (result.rmsErrorDB, 3)
+              << " dB rms" << juce::newLine;
+        }
+
+        return r;
+    }
+
+    //==============================================================================
+    // STFT dynamics at both FFT sizes, 75% overlap, with the default 8-band layout as
+    // the threshold curve. Thresholds sit below the noise so every covered bin is
+    // reducing and the whole gain path runs.
+    static juce::String runSpectralDynamics (double sampleRate)
+    {
+        static constexpr int numBands = DSPFixture::numDefaultBands;
+        using Spectral = SpectralDynamics<numBands>;
+
+        std::array<Spectral::Band, numBands> curve;
+        for (int b = 0; b < numBands; ++b)
+        {
+            auto& band = curve[static_cast<size_t> (b)];
+            band.index = b;
+            band.params = DSPFixture::getDefaultBand (b);
+            band.params.threshold = -70.0f;
+        }
+
+        juce::AudioBuffer<float> source (numChannels, blockSize), work (numChannels, blockSize);
+        DSPFixture::fillNoise (source, juce::Decibels::decibelsToGain (-24.0f));
+
+        juce::String r;
+        r << "Spectral dynamics (75% overlap, 8-band curve, " << numChannels << " ch linked)" << juce::newLine;
+
+        for (int order = Spectral::minOrder; order <= Spectral::maxOrder; ++order)
+        {
+            auto spectral = std::make_unique<Spectral>();
+            spectral->prepare (sampleRate, numChannels);
+            spectral->setOrder (order);
+            spectral->setBands (curve.data(), numBands);
+
+            const double ns = measureNsPerSample ([&]
+            {
+                work.makeCopyOf (source, true);
+                spectral->process (work);
+            }, blockSize, numBlocks);
+
+            const int n = spectral->getFFTSize();
+            r << formatLine ("FFT " + juce::String (n), ns)
+              << formatLine ("FFT " + juce::String (n) + " per frame (hop " + juce::String (n / Spectral::overlap) + ")",
+                             ns * n / Spectral::overlap * 1.0e-3, "us/frame");
+        }
+
+        return r;
+    }
+
+    //==============================================================================
+    static juce::String runAll (double sampleRate)
+    {
+        juce::String r;
+        r << "DSP benchmarks @ " << juce::String (sampleRate, 0) << " Hz, block " << blockSize
+          << ", " << numChannels << " ch" << juce::newLine << juce::newLine;
+        r << runBandCascade (sampleRate) << juce::newLine
+          << runBiquadKernels (sampleRate) << juce::newLine
+          << runDetectorBank (sampleRate) << juce::newLine
+          << runCurveEvaluation (sampleRate) << juce::newLine
+          << runAxisMapping (sampleRate) << juce::newLine
+          << runAnalyzer() << juce::newLine
+          << runAnalyzerPair() << juce::newLine
+          << runFFTBackends() << juce::newLine
+          << runMatchFit (sampleRate) << juce::newLine
+          << runSpectralDynamics (sampleRate);
+        return r;
+    }
+};
@@ -0,0 +1,222 @@
+/*
+  ==============================================================================
+
+    DSPFixture.h
+    Shared setup for the DSP tests and benchmarks
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSP/DynamicEQBand.h"
+#include "DSP/DetectorBank.h"
+#include "DSP/SpectrumAnalyzer.h"
+
+namespace DSPFixture
+{
+    static constexpr int blockSize   = 512;
+    static constexpr int numChannels = 2;
+
+    // Uniform noise in [-peakGain, peakGain], the same on every run
+    inline void fillNoise (juce::AudioBuffer<float>& buffer, float peakGain)
+    {
+        juce::Random random (0x5eed);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer (ch);
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                data[i] = (random.nextFloat() * 2.0f - 1.0f) * peakGain;
+        }
+    }
+
+    //==============================================================================
+    // The plugin's default layout of its first bands (see createParameterLayout):
+    // a low shelf, six peaks and a high shelf, all at 0 dB
+    static constexpr int numDefaultBands = 8;
+
+    inline BandParams getDefaultBand (int index)
+    {
+        static constexpr float frequencies[numDefaultBands] = { 60.0f, 200.0f, 500.0f, 1000.0f,
+                                                                2000.0f, 5000.0f, 10000.0f, 16000.0f };
+        jassert (juce::isPositiveAndBelow (index, numDefaultBands));
+
+        BandParams p;
+        p.frequency = frequencies[index];
+        p.type = (index == 0) ? BandParams::FilterType::LowShelf
+               : (index == numDefaultBands - 1) ? BandParams::FilterType::HighShelf
+                                                : BandParams::FilterType::Peak;
+        return p;
+    }
+
+    // One setting per filter type, clear of the band edges
+    struct FilterSetting
+    {
+        BandParams::FilterType type;
+        const char* name;
+        float freq, q, gainDB;
+    };
+
+    inline const std::array<FilterSetting, 7>& getFilterSettings()
+    {
+        using Type = BandParams::FilterType;
+        static const std::array<FilterSetting, 7> settings {{
+            { Type::LowShelf,  "Low shelf",  120.0f,   0.7f,  4.0f },
+            { Type::Peak,      "Peak",       1000.0f,  2.0f,  6.0f },
+            { Type::HighShelf, "High shelf", 8000.0f,  0.7f, -4.0f },
+            { Type::LowCut,    "Low cut",    40.0f,    0.7f,  0.0f },
+            { Type::HighCut,   "High cut",   15000.0f, 0.7f,  0.0f },
+            { Type::Notch,     "Notch",      3000.0f,  8.0f,  0.0f },
+            { Type::BandPass,  "Band pass",  2000.0f,  1.0f,  0.0f },
+        }};
+        return settings;
+    }
+
+    //==============================================================================
+    // The scalar per-band detector the DetectorBank replaced (std::exp coefficients,
+    // std::pow per block, Decibels conversions), kept as its reference
+    struct ScalarDetector
+    {
+        float attack = 0.0f, release = 0.0f, envelope = 0.0f, threshold = 0.0f, ratio = 1.0f;
+
+        float process (float level, int numSamples)
+        {
+            const float levelDB = juce::Decibels::gainToDecibels (level, -100.0f);
+            const float in = juce::Decibels::decibelsToGain (levelDB, -100.0f);
+            float coeff = (in > envelope) ? attack : release;
+            if (numSamples > 1)
+                coeff = std::pow (coeff, static_cast<float> (numSamples));
+            envelope = coeff * envelope + (1.0f - coeff) * in;
+
+            const float envDB = juce::Decibels::gainToDecibels (envelope, -100.0f);
+            const float excess = envDB - threshold;
+            return excess > 0.0f ? excess - excess / ratio : 0.0f;
+        }
+    };
+
+    // Detector bands with spread times, thresholds and ratios
+    static constexpr int numDetectorBands = 32;
+
+    struct DetectorSetting
+    {
+        float attackMs, releaseMs, thresholdDB, ratio;
+    };
+
+    inline DetectorSetting getDetectorBand (int index)
+    {
+        const auto b = static_cast<float> (index);
+        return { 1.0f + 0.6f * b, 40.0f + 8.0f * b, -40.0f + b, 1.5f + 0.25f * b };
+    }
+
+    // Detector bank and its scalar reference over the same bands
+    struct DetectorPair
+    {
+        DetectorBank<numDetectorBands> bank;
+        std::array<ScalarDetector, numDetectorBands> scalar;
+
+        void prepare (double sampleRate)
+        {
+            bank.prepare (sampleRate);
+
+            for (int b = 0; b < numDetectorBands; ++b)
+            {
+                const auto d = getDetectorBand (b);
+                bank.setBand (b, d.attackMs, d.releaseMs, d.thresholdDB, d.ratio, true);
+
+                auto& s = scalar[static_cast<size_t> (b)];
+                s.attack    = std::exp (-1.0f / (static_cast<float> (sampleRate) * d.attackMs * 0.001f));
+                s.release   = std::exp (-1.0f / (static_cast<float> (sampleRate) * d.releaseMs * 0.001f));
+                s.threshold = d.thresholdDB;
+                s.ratio     = d.ratio;
+            }
+        }
+
+        void reset()
+        {
+            bank.reset();
+            for (auto& s : scalar)
+                s.envelope = 0.0f;
+        }
+    };
+
+    // Peak levels of noise under a slow 30 dB swell, so the bands move in and out of reduction
+    inline std::vector<float> makeDetectorLevels (size_t numLevels)
+    {
+        std::vector<float> levels (numLevels);
+        juce::Random random (0x5eed);
+        for (size_t i = 0; i < levels.size(); ++i)
+        {
+            const float swell = 0.5f - 0.5f * std::cos (juce::MathConstants<float>::twoPi * static_cast<float> (i) / 48000.0f);
+            levels[i] = random.nextFloat() * juce::Decibels::decibelsToGain (-36.0f + 30.0f * swell);
+        }
+        return levels;
+    }
+
+    //==============================================================================
+    // Pre- and post-EQ analyzers fed channels 0 and 1 of the same input, analysed
+    // either as two real transforms or as one packed complex FFT
+    struct AnalyzerPair
+    {
+        SpectrumAnalyzer pre, post;
+        std::vector<float> preDB, postDB;
+
+        void setConfig (const SpectrumAnalyzer::Config& config)
+        {
+            pre.setConfig (config);
+            post.setConfig (config);
+        }
+
+        void push (const juce::AudioBuffer<float>& input)
+        {
+            pre.pushSamples (input.getReadPointer (0), input.getNumSamples());
+            post.pushSamples (input.getReadPointer (1), input.getNumSamples());
+        }
+
+        void analyseSeparately()
+        {
+            pre.processFFT (preDB);
+            post.processFFT (postDB);
+        }
+
+        void analysePacked()
+        {
+            SpectrumAnalyzer::processFFTPair (pre, post, preDB, postDB);
+        }
+
+        // Largest difference of the last linear magnitudes (before the dB conversion and its
+        // -100 dB clamp) from another pair's, relative to the strongest bin of either channel
+        float getRelativeDifference (const AnalyzerPair& other, int numBins) const
+        {
+            const SpectrumAnalyzer* mine[]   = { &pre, &post };
+            const SpectrumAnalyzer* theirs[] = { &other.pre, &other.post };
+            float peak = 0.0f, maxError = 0.0f;
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                const float* a = mine[ch]->getLastMagnitudes();
+                const float* b = theirs[ch]->getLastMagnitudes();
+                for (int i = 0; i < numBins; ++i)
+                {
+                    peak = juce::jmax (peak, a[i]);
+                    maxError = juce::jmax (maxError, std::abs (a[i] - b[i]));
+                }
+            }
+
+            return maxError / juce::jmax (peak, std::numeric_limits<float>::min());
+        }
+    };
+
+    // Loud noise for the pre channel beside a quiet post signal (a -60 dBFS sine over
+    // -100 dBFS noise), so leakage of one into the other cannot hide below the clamp
+    inline void fillAnalyzerPairInput (juce::AudioBuffer<float>& input)
+    {
+        jassert (input.getNumChannels() >= 2);
+        fillNoise (input, 0.5f);
+
+        auto* post = input.getWritePointer (1);
+        juce::FloatVectorOperations::multiply (post, 2.0e-5f, input.getNumSamples());
+        for (int i = 0; i < input.getNumSamples(); ++i)
+            post[i] += 1.0e-3f * std::sin (0.05f * static_cast<float> (i));
+    }
+}
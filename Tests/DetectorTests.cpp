@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    DetectorTests.cpp
+    Level detection: the DetectorBank against the scalar per-band detector, and
+    the threshold a resonance suggestion gives its band
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "DSP/ResonanceDetector.h"
+#include "DSPFixture.h"
+
+//==============================================================================
+// The DetectorBank's float state, FastMath coefficients and dB conversion must stay
+// within the bounds DetectorBank.h documents of the same detector computed in double
+// precision, updated per sample and per block, from cleared envelopes over the same
+// levels (one level per update, so the per-block run spans many swells).
+class DetectorBankTest : public juce::UnitTest
+{
+public:
+    DetectorBankTest() : juce::UnitTest ("Detector bank", "DynamicEQ") {}
+
+    // Largest gain-reduction difference in dB
+    static constexpr double perSampleToleranceDB = 3.0e-3;
+    static constexpr double perBlockToleranceDB  = 1.0e-4;
+
+    void runTest() override
+    {
+        constexpr int numBands = DSPFixture::numDetectorBands, blockSize = DSPFixture::blockSize;
+        const double sampleRate = 48000.0;
+
+        auto detectors = std::make_unique<DSPFixture::DetectorPair>();
+        detectors->prepare (sampleRate);
+
+        std::array<Reference, numBands> reference;
+        for (int b = 0; b < numBands; ++b)
+            reference[static_cast<size_t> (b)].setUp (sampleRate, DSPFixture::getDetectorBand (b));
+
+        const auto levels = DSPFixture::makeDetectorLevels (200 * blockSize);
+        std::array<float, numBands> reductions {};
+
+        for (int step : { 1, blockSize })
+        {
+            beginTest (step == 1 ? "Per sample" : "Per block");
+
+            detectors->reset();
+            for (auto& r : reference)
+                r.envelope = 0.0;
+
+            double maxDeviation = 0.0;
+            for (const float level : levels)
+            {
+                detectors->bank.process (level, step, numBands, reductions.data());
+
+                for (size_t b = 0; b < reference.size(); ++b)
+                    maxDeviation = juce::jmax (maxDeviation, std::abs (reductions[b] - reference[b].process (level, step)));
+            }
+
+            expectLessOrEqual (maxDeviation, step == 1 ? perSampleToleranceDB : perBlockToleranceDB);
+        }
+    }
+
+private:
+    // The detector of DetectorBank.h in double precision, with the bank's level floor
+    struct Reference
+    {
+        double attackSamples = 0.0, releaseSamples = 0.0, envelope = 0.0, threshold = 0.0, slope = 0.0;
+
+        void setUp (double sampleRate, const DSPFixture::DetectorSetting& d)
+        {
+            attackSamples  = sampleRate * d.attackMs * 0.001;
+            releaseSamples = sampleRate * d.releaseMs * 0.001;
+            threshold = d.thresholdDB;
+            slope = 1.0 - 1.0 / static_cast<double> (d.ratio);
+        }
+
+        double process (float level, int numSamples)
+        {
+            const double in = level > DetectorBank<1>::floorGain ? level : 0.0;
+            const double coeff = std::exp (-numSamples / (in > envelope ? attackSamples : releaseSamples));
+            envelope = in + coeff * (envelope - in);
+
+            const double envDB = 20.0 * std::log10 (juce::jmax (envelope, static_cast<double> (DetectorBank<1>::floorGain)));
+            return juce::jmax (0.0, envDB - threshold) * slope;
+        }
+    };
+};
+
+static DetectorBankTest detectorBankTest;
+
+//==============================================================================
+// A band placed from a resonance suggestion, fed steady input (noise with a slow
+// +-3 dB swell): its threshold from ResonanceDetector::getBandThresholdDB must leave
+// the steady signal alone and still catch a 12 dB rise.
+class ResonanceThresholdTest : public juce::UnitTest
+{
+public:
+    ResonanceThresholdTest() : juce::UnitTest ("Resonance band threshold", "DynamicEQ") {}
+
+    // Largest reduction on the steady signal, smallest on the rise
+    static constexpr float maxSteadyReductionDB = 0.5f;
+    static constexpr float minRiseReductionDB   = 3.0f;
+
+    void runTest() override
+    {
+        constexpr int blockSize = DSPFixture::blockSize;
+        const double sampleRate = 48000.0;
+
+        DetectorBank<1> bank;
+        bank.prepare (sampleRate);
+        bank.setBand (0, 10.0f, 100.0f, 0.0f, 4.0f, false);
+
+        juce::Random random (0x5eed);
+        const int blocksPerSecond = static_cast<int> (sampleRate / blockSize);
+        int blockIndex = 0;
+        float reduction = 0.0f;
+
+        // Block peak of roughly Gaussian noise at -6 dBFS, scaled by gainDB
+        const auto runSeconds = [&] (float seconds, float gainDB)
+        {
+            float maxReduction = 0.0f;
+            for (int b = 0; b < static_cast<int> (seconds * static_cast<float> (blocksPerSecond)); ++b, ++blockIndex)
+            {
+                const float swellDB = 3.0f * std::sin (juce::MathConstants<float>::twoPi * static_cast<float> (blockIndex)
+                                                       / static_cast<float> (4 * blocksPerSecond));
+                const float gain = juce::Decibels::decibelsToGain (-6.0f + swellDB + gainDB) / 3.0f;
+
+                float peak = 0.0f;
+                for (int i = 0; i < blockSize; ++i)
+                    peak = juce::jmax (peak, std::abs (random.nextFloat() + random.nextFloat() + random.nextFloat() - 1.5f) * gain);
+
+                bank.process (peak, blockSize, 1, &reduction);
+                maxReduction = juce::jmax (maxReduction, reduction);
+            }
+            return maxReduction;
+        };
+
+        runSeconds (4.0f, 0.0f);   // detection warm-up, band not placed yet
+
+        const float thresholdDB = ResonanceDetector::getBandThresholdDB (bank.getLongTermLevelDB());
+        bank.setBand (0, 10.0f, 100.0f, thresholdDB, 4.0f, true);
+        logMessage ("Threshold " + juce::String (thresholdDB, 1) + " dB");
+
+        beginTest ("Steady input");
+        expectLessThan (runSeconds (8.0f, 0.0f), maxSteadyReductionDB);
+
+        beginTest ("12 dB rise");
+        expectGreaterThan (runSeconds (1.0f, 12.0f), minRiseReductionDB);
+    }
+};
+
+static ResonanceThresholdTest resonanceThresholdTest;
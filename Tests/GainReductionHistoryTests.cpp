@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    GainReductionHistoryTests.cpp
+    Gain reduction history: reads of a full ring and reads racing the writer
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <thread>
+#include "DSP/GainReductionHistory.h"
+
+//==============================================================================
+// Frame k holds k in all three fields, so a frame returned torn or from the wrong
+// position shows up as a mismatch. First a single-threaded read of a ring filled
+// exactly to capacity, then a reader racing a writer thread that keeps lapping it.
+class GainReductionHistoryTest : public juce::UnitTest
+{
+public:
+    GainReductionHistoryTest() : juce::UnitTest ("Gain reduction history", "DynamicEQ") {}
+
+    void runTest() override
+    {
+        auto history = std::make_unique<History>();
+        history->allocate (1);
+        history->prepare (History::framesPerSecond);   // one sample per frame
+
+        std::vector<Frame> frames (static_cast<size_t> (capacity));
+
+        beginTest ("Read of a full ring");
+        {
+            for (int k = 0; k < capacity; ++k)
+                history->push (0, static_cast<float> (k), 1);
+
+            // The oldest slot is the next one the writer reuses, so it is not returned
+            juce::int64 first = 0;
+            const int num = history->readFrames (0, first, frames.data(), capacity);
+            expectEquals (num, capacity - 1);
+            expectEquals (static_cast<int> (first - num), 1);
+            expectEquals (countMismatches (frames, first - num, num), 0);
+        }
+
+        beginTest ("Reads racing the writer");
+        {
+            // The reader always asks for the oldest frames, which the writer laps
+            static constexpr int numRacedFrames = 1 << 22;
+            std::atomic<bool> writing { true };
+            std::thread writer ([&]
+            {
+                for (int k = capacity; k < numRacedFrames; ++k)
+                    history->push (0, static_cast<float> (k), 1);
+                writing.store (false);
+            });
+
+            int numReads = 0, numBad = 0;
+            while (writing.load())
+            {
+                juce::int64 first = 0;
+                const int num = history->readFrames (0, first, frames.data(), capacity);
+                numBad += countMismatches (frames, first - num, num);
+                ++numReads;
+            }
+            writer.join();
+
+            expectEquals (numBad, 0, juce::String (numReads) + " reads");
+        }
+    }
+
+private:
+    using History = GainReductionHistory<1>;
+    using Frame = History::Frame;
+    static constexpr int capacity = History::capacity;
+
+    static int countMismatches (const std::vector<Frame>& frames, juce::int64 first, int num)
+    {
+        int bad = 0;
+        for (int i = 0; i < num; ++i)
+        {
+            const auto expected = static_cast<float> (first + i);
+            const auto& f = frames[static_cast<size_t> (i)];
+            bad += (f.minDB != expected || f.maxDB != expected || f.meanDB != expected) ? 1 : 0;
+        }
+        return bad;
+    }
+};
+
+static GainReductionHistoryTest gainReductionHistoryTest;
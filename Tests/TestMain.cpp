@@ -0,0 +1,24 @@
+/*
+  ==============================================================================
+
+    TestMain.cpp
+    Console runner for the DynamicEQ unit tests (run by CTest)
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+// Runs every juce::UnitTest in the "DynamicEQ" category; exits with 1 if any check failed
+int main()
+{
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure (false);
+    runner.runTestsInCategory ("DynamicEQ");
+
+    int failures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        failures += runner.getResult (i)->failures;
+
+    return failures > 0 ? 1 : 0;
+}